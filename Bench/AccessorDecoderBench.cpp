@@ -0,0 +1,137 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 14:24:09
+//
+
+#include "Bench.hpp"
+#include "Util/AccessorDecoder.hpp"
+#include "Util/TangentCalculator.hpp"
+
+#include <cstring>
+#include <random>
+
+#define ACCESSOR_BENCH_VERTICES (1 << 20)
+#define ACCESSOR_BENCH_INDICES (3 << 21)
+
+/// @note(ame): one primitive worth of accessors over a single interleaved buffer, the way exporters lay them out.
+struct SyntheticPrimitive
+{
+    std::vector<uint8_t> Data;
+    cgltf_buffer_view View = {};
+    cgltf_buffer_view IndexView = {};
+    cgltf_accessor Position = {};
+    cgltf_accessor Normal = {};
+    cgltf_accessor UV = {};
+    cgltf_accessor Indices = {};
+};
+
+/// @note(ame): float attributes, or KHR_mesh_quantization ones (snorm16 position/normal, unorm16 UV) with 16-bit indices.
+static void BuildPrimitive(SyntheticPrimitive& out, bool quantized)
+{
+    std::mt19937 rng(1);
+
+    cgltf_size vertexStride = quantized ? 8 + 8 + 4 : 12 + 12 + 8;
+    cgltf_size indexSize = quantized ? 2 : 4;
+    cgltf_size vertexBytes = vertexStride * ACCESSOR_BENCH_VERTICES;
+    out.Data.resize(vertexBytes + indexSize * ACCESSOR_BENCH_INDICES);
+    for (uint8_t& byte : out.Data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    if (!quantized) {
+        // Random bytes make NaNs and denormals, which would time something no asset has
+        std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+        for (size_t i = 0; i < vertexBytes; i += sizeof(float)) {
+            float f = value(rng);
+            memcpy(&out.Data[i], &f, sizeof(float));
+        }
+    }
+    for (size_t i = 0; i < ACCESSOR_BENCH_INDICES; i++) {
+        uint32_t index = rng() % (quantized ? 65536 : ACCESSOR_BENCH_VERTICES);
+        memcpy(&out.Data[vertexBytes + i * indexSize], &index, indexSize);
+    }
+
+    out.View.data = out.Data.data();
+    out.View.size = vertexBytes;
+    out.View.stride = vertexStride;
+    out.IndexView.data = out.Data.data() + vertexBytes;
+    out.IndexView.size = indexSize * ACCESSOR_BENCH_INDICES;
+
+    auto attribute = [&](cgltf_accessor& accessor, cgltf_type type, cgltf_size offset) {
+        accessor.buffer_view = &out.View;
+        accessor.type = type;
+        accessor.offset = offset;
+        accessor.count = ACCESSOR_BENCH_VERTICES;
+        accessor.stride = vertexStride;
+    };
+    attribute(out.Position, cgltf_type_vec3, 0);
+    attribute(out.Normal, cgltf_type_vec3, quantized ? 8 : 12);
+    attribute(out.UV, cgltf_type_vec2, quantized ? 16 : 24);
+    out.Position.component_type = quantized ? cgltf_component_type_r_16 : cgltf_component_type_r_32f;
+    out.Normal.component_type = quantized ? cgltf_component_type_r_16 : cgltf_component_type_r_32f;
+    out.UV.component_type = quantized ? cgltf_component_type_r_16u : cgltf_component_type_r_32f;
+    out.Position.normalized = out.Normal.normalized = out.UV.normalized = quantized;
+
+    out.Indices.buffer_view = &out.IndexView;
+    out.Indices.type = cgltf_type_scalar;
+    out.Indices.component_type = quantized ? cgltf_component_type_r_16u : cgltf_component_type_r_32u;
+    out.Indices.count = ACCESSOR_BENCH_INDICES;
+    out.Indices.stride = indexSize;
+}
+
+/// @note(ame): what ProcessPrimitive used to do, one cgltf call per attribute per vertex and per index, into unreserved vectors.
+static void DecodePerElement(const SyntheticPrimitive& primitive, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    vertices.clear();
+    vertices.shrink_to_fit();
+    indices.clear();
+    indices.shrink_to_fit();
+
+    for (cgltf_size i = 0; i < primitive.Position.count; i++) {
+        Vertex vertex = {};
+        float value[4];
+        if (cgltf_accessor_read_float(&primitive.Position, i, value, 4)) {
+            vertex.Position = glm::vec3(value[0], value[1], value[2]);
+        }
+        if (cgltf_accessor_read_float(&primitive.UV, i, value, 4)) {
+            vertex.UV = glm::vec2(value[0], value[1]);
+        }
+        if (cgltf_accessor_read_float(&primitive.Normal, i, value, 4)) {
+            vertex.Normal = glm::vec3(value[0], value[1], value[2]);
+        }
+        vertices.push_back(vertex);
+    }
+    for (cgltf_size i = 0; i < primitive.Indices.count; i++) {
+        indices.push_back(static_cast<uint32_t>(cgltf_accessor_read_index(&primitive.Indices, i)));
+    }
+}
+
+static void DecodeBulk(const SyntheticPrimitive& primitive, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    vertices.assign(primitive.Position.count, Vertex{});
+    indices.resize(primitive.Indices.count);
+
+    AccessorDecoder::DecodeFloats(&primitive.Position, &vertices[0].Position.x, vertices.size(), sizeof(Vertex), 3);
+    AccessorDecoder::DecodeFloats(&primitive.UV, &vertices[0].UV.x, vertices.size(), sizeof(Vertex), 2);
+    AccessorDecoder::DecodeFloats(&primitive.Normal, &vertices[0].Normal.x, vertices.size(), sizeof(Vertex), 3);
+    AccessorDecoder::DecodeIndices(&primitive.Indices, indices.data());
+}
+
+BENCH(AccessorDecode)
+{
+    for (bool quantized : { false, true }) {
+        SyntheticPrimitive primitive;
+        BuildPrimitive(primitive, quantized);
+
+        std::vector<Vertex> perElementVertices;
+        std::vector<uint32_t> perElementIndices;
+        std::vector<Vertex> bulkVertices;
+        std::vector<uint32_t> bulkIndices;
+        double perElement = MeasureMs(5, [&]() { DecodePerElement(primitive, perElementVertices, perElementIndices); });
+        double bulk = MeasureMs(5, [&]() { DecodeBulk(primitive, bulkVertices, bulkIndices); });
+
+        bool identical = perElementIndices == bulkIndices && memcmp(perElementVertices.data(), bulkVertices.data(), bulkVertices.size() * sizeof(Vertex)) == 0;
+        LOG_INFO("    {} vertices + {} indices, {}: per element {:.1f}ms, bulk {:.1f}ms ({:.1f}x), output {}",
+                 ACCESSOR_BENCH_VERTICES, ACCESSOR_BENCH_INDICES, quantized ? "quantized int16, 16-bit indices" : "float, 32-bit indices",
+                 perElement, bulk, perElement / bulk, identical ? "identical" : "DIFFERENT");
+    }
+}
@@ -0,0 +1,56 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 14:05:22
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+    Load path benchmarks, CPU only: nothing here creates a window or touches the GPU.
+    BENCH(Name) registers a function at static init time, Bench/Main.cpp runs them all, or the ones whose name contains the first argument:
+        xmake build bench && xmake run bench [filter]
+    Asset benches read Assets/ from the run directory and skip themselves if the asset is missing.
+    Results are logged, there is nothing to pass or fail.
+*/
+
+typedef void (*BenchFunction)();
+
+struct BenchCase
+{
+    const char* Name;
+    BenchFunction Function;
+};
+
+class BenchRegistry
+{
+public:
+    static bool Register(const char* name, BenchFunction function);
+    static void Run(const std::string& filter);
+private:
+    static std::vector<BenchCase>& GetBenches();
+};
+
+#define BENCH(name) \
+    static void Bench_##name(); \
+    static bool Bench_##name##_Registered = BenchRegistry::Register(#name, Bench_##name); \
+    static void Bench_##name()
+
+/// @note(ame): best of runs, in milliseconds. The best run is the one least disturbed by the rest of the machine.
+template<typename F>
+double MeasureMs(uint32_t runs, F&& function)
+{
+    double best = 0.0;
+    for (uint32_t i = 0; i < runs; i++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        function();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        best = (i == 0 || ms < best) ? ms : best;
+    }
+    return best;
+}
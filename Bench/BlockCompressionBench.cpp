@@ -0,0 +1,210 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 16:20:31
+//
+
+#include "Bench.hpp"
+#include "Util/BlockCompression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+/*
+    Quality and throughput of the block encoder on the DamagedHelmet maps, top level only.
+    PSNR is measured on blocks decoded by the small reference decoders below, written from the format descriptions
+    rather than from the encoder, over the channels the format stores.
+*/
+
+static void Expand565(uint16_t color, int* out)
+{
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+static void DecodeBC1(const uint8_t* block, uint8_t* out)
+{
+    uint16_t c0 = block[0] | (block[1] << 8);
+    uint16_t c1 = block[2] | (block[3] << 8);
+    uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (uint32_t(block[7]) << 24);
+
+    int palette[4][4];
+    Expand565(c0, palette[0]);
+    Expand565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        if (c0 > c1) {
+            palette[2][c] = static_cast<int>(std::lround((2.0 * palette[0][c] + palette[1][c]) / 3.0));
+            palette[3][c] = static_cast<int>(std::lround((palette[0][c] + 2.0 * palette[1][c]) / 3.0));
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = c0 > c1 ? 255 : 0;
+
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            out[i * 4 + c] = static_cast<uint8_t>(palette[(indices >> (2 * i)) & 3][c]);
+        }
+    }
+}
+
+static void DecodeBC4(const uint8_t* block, uint8_t* out, int stride)
+{
+    int a0 = block[0];
+    int a1 = block[1];
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) {
+        bits |= uint64_t(block[2 + i]) << (8 * i);
+    }
+
+    double palette[8] = { double(a0), double(a1) };
+    if (a0 > a1) {
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7.0;
+        }
+    } else {
+        for (int i = 1; i < 5; i++) {
+            palette[i + 1] = ((5 - i) * a0 + i * a1) / 5.0;
+        }
+        palette[6] = 0.0;
+        palette[7] = 255.0;
+    }
+    for (int i = 0; i < 16; i++) {
+        out[i * stride] = static_cast<uint8_t>(std::lround(palette[(bits >> (3 * i)) & 7]));
+    }
+}
+
+/// @note(ame): mode 6 only, the only mode the encoder writes.
+static void DecodeBC7(const uint8_t* block, uint8_t* out)
+{
+    uint32_t position = 0;
+    auto read = [&](uint32_t count) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < count; i++, position++) {
+            value |= ((block[position / 8] >> (position % 8)) & 1u) << i;
+        }
+        return value;
+    };
+
+    if (read(7) != 64) {
+        memset(out, 0, 64);
+        return;
+    }
+    int endpoints[2][4];
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] = read(7);
+        endpoints[1][c] = read(7);
+    }
+    int p0 = read(1);
+    int p1 = read(1);
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] = (endpoints[0][c] << 1) | p0;
+        endpoints[1][c] = (endpoints[1][c] << 1) | p1;
+    }
+
+    static const int WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+    for (int i = 0; i < 16; i++) {
+        int index = read(i == 0 ? 3 : 4);
+        for (int c = 0; c < 4; c++) {
+            out[i * 4 + c] = static_cast<uint8_t>(((64 - WEIGHTS[index]) * endpoints[0][c] + WEIGHTS[index] * endpoints[1][c] + 32) >> 6);
+        }
+    }
+}
+
+static void DecodeLevel(const uint8_t* blocks, uint32_t width, uint32_t height, BlockFormat format, std::vector<uint8_t>& out)
+{
+    out.assign(size_t(width) * height * 4, 0);
+    uint32_t blocksX = (width + 3) / 4;
+    uint32_t blocksY = (height + 3) / 4;
+    for (uint32_t by = 0; by < blocksY; by++) {
+        for (uint32_t bx = 0; bx < blocksX; bx++) {
+            const uint8_t* block = blocks + (size_t(by) * blocksX + bx) * BlockBytes(format);
+            uint8_t texels[64] = {};
+            switch (format) {
+                case BlockFormat::BC1: DecodeBC1(block, texels); break;
+                case BlockFormat::BC4: DecodeBC4(block, texels, 4); break;
+                case BlockFormat::BC5: DecodeBC4(block, texels, 4); DecodeBC4(block + 8, texels + 1, 4); break;
+                case BlockFormat::BC7: DecodeBC7(block, texels); break;
+            }
+            for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++) {
+                for (uint32_t x = 0; x < 4 && bx * 4 + x < width; x++) {
+                    memcpy(&out[((size_t(by) * 4 + y) * width + bx * 4 + x) * 4], texels + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+    }
+}
+
+static double PSNR(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int channels)
+{
+    double squaredError = 0.0;
+    for (size_t i = 0; i < a.size(); i += 4) {
+        for (int c = 0; c < channels; c++) {
+            double difference = double(a[i + c]) - double(b[i + c]);
+            squaredError += difference * difference;
+        }
+    }
+    double mse = squaredError / (a.size() / 4 * channels);
+    return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+BENCH(BlockCompression)
+{
+    struct Case
+    {
+        const char* Path;
+        const char* Name;
+        BlockFormat Format;
+        int Channels;
+        bool Swizzle;
+    };
+    const Case cases[] = {
+        { "Assets/DamagedHelmet/Default_albedo.jpg", "albedo", BlockFormat::BC7, 4, false },
+        { "Assets/DamagedHelmet/Default_albedo.jpg", "albedo", BlockFormat::BC1, 3, false },
+        { "Assets/DamagedHelmet/Default_normal.jpg", "normal", BlockFormat::BC5, 2, false },
+        { "Assets/DamagedHelmet/Default_metalRoughness.jpg", "roughness/metallic", BlockFormat::BC5, 2, true },
+        { "Assets/DamagedHelmet/Default_AO.jpg", "occlusion", BlockFormat::BC4, 1, false }
+    };
+    const char* names[] = { "BC1", "BC4", "BC5", "BC7" };
+
+    for (const Case& entry : cases) {
+        if (!std::filesystem::exists(entry.Path)) {
+            LOG_WARN("    {} is missing, skipped", entry.Path);
+            continue;
+        }
+
+        ImageData image;
+        image.Load(entry.Path);
+        if (image.Width % 4 != 0 || image.Height % 4 != 0) {
+            LOG_WARN("    {} isn't made of whole blocks, skipped", entry.Path);
+            continue;
+        }
+        // Same swizzle as TextureCache::Process, roughness and metallic into R and G
+        if (entry.Swizzle) {
+            for (size_t i = 0; i < image.Pixels.size(); i += 4) {
+                image.Pixels[i + 0] = image.Pixels[i + 1];
+                image.Pixels[i + 1] = image.Pixels[i + 2];
+            }
+        }
+
+        std::vector<uint8_t> serial;
+        std::vector<uint8_t> parallel;
+        double serialMs = MeasureMs(1, [&]() { CompressMipChain(image.Pixels.data(), image.Width, image.Height, 1, entry.Format, serial, false); });
+        double parallelMs = MeasureMs(1, [&]() { CompressMipChain(image.Pixels.data(), image.Width, image.Height, 1, entry.Format, parallel, true); });
+
+        std::vector<uint8_t> decoded;
+        DecodeLevel(serial.data(), image.Width, image.Height, entry.Format, decoded);
+
+        double megabytes = image.Pixels.size() / (1024.0 * 1024.0);
+        LOG_INFO("    {} {}x{} {}: PSNR {:.2f}dB, {:.1f}MB/s on one thread, {:.1f}MB/s on the job system{}",
+                 entry.Name, image.Width, image.Height, names[static_cast<uint32_t>(entry.Format)], PSNR(image.Pixels, decoded, entry.Channels),
+                 megabytes / (serialMs / 1000.0), megabytes / (parallelMs / 1000.0), serial == parallel ? "" : ", parallel output DIFFERENT");
+    }
+}
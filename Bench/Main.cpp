@@ -0,0 +1,41 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 14:11:47
+//
+
+#include "Bench.hpp"
+#include "Util/JobSystem.hpp"
+
+std::vector<BenchCase>& BenchRegistry::GetBenches()
+{
+    static std::vector<BenchCase> benches;
+    return benches;
+}
+
+bool BenchRegistry::Register(const char* name, BenchFunction function)
+{
+    GetBenches().push_back({ name, function });
+    return true;
+}
+
+void BenchRegistry::Run(const std::string& filter)
+{
+    for (BenchCase& bench : GetBenches()) {
+        if (!filter.empty() && std::string(bench.Name).find(filter) == std::string::npos) {
+            continue;
+        }
+        LOG_INFO("{}", bench.Name);
+        bench.Function();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Oslo::Init();
+    JobSystem::Init();
+
+    BenchRegistry::Run(argc > 1 ? argv[1] : "");
+
+    JobSystem::Exit();
+    Oslo::Exit();
+}
@@ -0,0 +1,96 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 15:18:50
+//
+
+#include "Bench.hpp"
+#include "Model.hpp"
+#include "Cache/ModelCooker.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+static const char* MODEL_BENCH_ASSETS[] = {
+    "Assets/Sponza/Sponza.gltf",
+    "Assets/DamagedHelmet/DamagedHelmet.gltf"
+};
+
+static bool SameGeometry(const GLTFSceneDesc& a, const GLTFSceneDesc& b)
+{
+    if (a.Primitives.size() != b.Primitives.size() || a.Materials.size() != b.Materials.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.Primitives.size(); i++) {
+        const GLTFPrimitiveDesc& pa = a.Primitives[i];
+        const GLTFPrimitiveDesc& pb = b.Primitives[i];
+        if (pa.VertexCount != pb.VertexCount || pa.IndexCount != pb.IndexCount || pa.Material != pb.Material) {
+            return false;
+        }
+        if (memcmp(pa.Vertices, pb.Vertices, pa.VertexCount * sizeof(Vertex)) != 0 || memcmp(pa.Indices, pb.Indices, pa.IndexCount * sizeof(uint32_t)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @note(ame): GLTF::Prepare only, the CPU half of a load. Finish (buffers, BLASes, textures) needs a device.
+BENCH(ModelPrepare)
+{
+    for (const char* path : MODEL_BENCH_ASSETS) {
+        if (!std::filesystem::exists(path)) {
+            LOG_WARN("    {} is missing, skipped", path);
+            continue;
+        }
+
+        // Parallel against serial primitive processing, cook disabled so both parse
+        GLTFLoadOptions options;
+        options.UseCook = false;
+
+        // Fresh models every run, GLTFPreparedModel isn't reusable
+        std::unique_ptr<GLTFPreparedModel> serial;
+        std::unique_ptr<GLTFPreparedModel> parallel;
+        options.Parallel = false;
+        double serialMs = MeasureMs(3, [&]() {
+            serial = std::make_unique<GLTFPreparedModel>();
+            GLTF::Prepare(path, options, *serial);
+        });
+        options.Parallel = true;
+        double parallelMs = MeasureMs(3, [&]() {
+            parallel = std::make_unique<GLTFPreparedModel>();
+            GLTF::Prepare(path, options, *parallel);
+        });
+        LOG_INFO("    {}: serial {:.1f}ms, parallel {:.1f}ms ({:.2f}x), output {}", path, serialMs, parallelMs, serialMs / parallelMs,
+                 SameGeometry(serial->GetScene(), parallel->GetScene()) ? "identical" : "DIFFERENT");
+    }
+}
+
+BENCH(ModelCook)
+{
+    for (const char* path : MODEL_BENCH_ASSETS) {
+        if (!std::filesystem::exists(path)) {
+            LOG_WARN("    {} is missing, skipped", path);
+            continue;
+        }
+
+        GLTFLoadOptions options;
+        options.UseCook = false;
+        GLTFPreparedModel parsed;
+        GLTF::Prepare(path, options, parsed);
+
+        // Cold start parses and writes the cook, warm starts map it
+        options.UseCook = true;
+        std::error_code error;
+        std::filesystem::remove(ModelCooker::GetCookPath(path, options), error);
+
+        GLTFPreparedModel cold;
+        GLTF::Prepare(path, options, cold);
+        std::unique_ptr<GLTFPreparedModel> warm;
+        double warmMs = MeasureMs(3, [&]() {
+            warm = std::make_unique<GLTFPreparedModel>();
+            GLTF::Prepare(path, options, *warm);
+        });
+        LOG_INFO("    {}: parse {:.1f}ms, cold {:.1f}ms (parse + cook write), warm {:.1f}ms ({}), output {}", path, parsed.PrepareMs, cold.PrepareMs, warmMs,
+                 warm->Cooked ? "cooked" : "NOT COOKED", SameGeometry(parsed.GetScene(), warm->GetScene()) ? "identical" : "DIFFERENT");
+    }
+}
@@ -0,0 +1,80 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 14:52:36
+//
+
+#include "Bench.hpp"
+#include "Util/TangentSpace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+/// @note(ame): size * size height field, 2 * (size - 1)^2 triangles.
+static void BuildGrid(uint32_t size, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    vertices.assign(size_t(size) * size, Vertex{});
+    indices.clear();
+    indices.reserve(size_t(size - 1) * (size - 1) * 6);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            float fx = x / static_cast<float>(size - 1);
+            float fy = y / static_cast<float>(size - 1);
+            Vertex& vertex = vertices[size_t(y) * size + x];
+            vertex.Position = glm::vec3(fx, 0.1f * std::sin(40.0f * fx) * std::cos(30.0f * fy), fy);
+            vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            vertex.UV = glm::vec2(fx * 8.0f, fy * 8.0f);
+        }
+    }
+    for (uint32_t y = 0; y + 1 < size; y++) {
+        for (uint32_t x = 0; x + 1 < size; x++) {
+            uint32_t a = y * size + x;
+            uint32_t c = a + size;
+            indices.insert(indices.end(), { a, c, a + 1, a + 1, c, c + 1 });
+        }
+    }
+}
+
+BENCH(TangentSpace)
+{
+    // 2 * 2236^2 = 10M triangles
+    std::vector<Vertex> source;
+    std::vector<uint32_t> indices;
+    BuildGrid(2237, source, indices);
+
+    for (bool shuffled : { false, true }) {
+        // Shuffled triangles scatter into random vertices, the worst case for the accumulators
+        if (shuffled) {
+            std::vector<uint32_t> order(indices.size() / 3);
+            for (uint32_t i = 0; i < order.size(); i++) {
+                order[i] = i;
+            }
+            std::shuffle(order.begin(), order.end(), std::mt19937(7));
+
+            std::vector<uint32_t> reordered(indices.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                std::copy(indices.begin() + order[i] * 3, indices.begin() + order[i] * 3 + 3, reordered.begin() + i * 3);
+            }
+            indices = std::move(reordered);
+        }
+
+        std::vector<Vertex> reference;
+        std::vector<Vertex> computed;
+        double referenceMs = MeasureMs(3, [&]() {
+            reference = source;
+            TangentSpace::ComputeReference(reference, indices);
+        });
+        double computeMs = MeasureMs(3, [&]() {
+            computed = source;
+            TangentSpace::Compute(computed.data(), computed.size(), indices.data(), indices.size());
+        });
+        std::vector<Vertex> copied;
+        double copyMs = MeasureMs(3, [&]() { copied = source; });
+
+        bool identical = memcmp(reference.data(), computed.data(), computed.size() * sizeof(Vertex)) == 0;
+        LOG_INFO("    {} triangles, {} order: ComputeReference {:.1f}ms, Compute {:.1f}ms ({:.2f}x), output {}",
+                 indices.size() / 3, shuffled ? "shuffled" : "grid", referenceMs - copyMs, computeMs - copyMs,
+                 (referenceMs - copyMs) / (computeMs - copyMs), identical ? "identical" : "DIFFERENT");
+    }
+}
@@ -0,0 +1,136 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 15:46:03
+//
+
+#include "Bench.hpp"
+#include "Model.hpp"
+#include "Cache/TextureCache.hpp"
+#include "Cache/TextureCooker.hpp"
+#include "Util/JobSystem.hpp"
+
+#include <filesystem>
+#include <future>
+#include <unordered_set>
+
+#define TEXTURE_BENCH_MODEL "Assets/Sponza/Sponza.gltf"
+
+struct BenchTexture
+{
+    std::string Path;
+    TextureKind Kind;
+};
+
+/// @note(ame): every texture the materials of the model reference, with the kind Finish would request it as.
+static bool CollectTextures(const std::string& path, std::vector<BenchTexture>& out)
+{
+    if (!std::filesystem::exists(path)) {
+        LOG_WARN("    {} is missing, skipped", path);
+        return false;
+    }
+
+    GLTFLoadOptions options;
+    options.UseCook = false;
+    GLTFPreparedModel prepared;
+    GLTF::Prepare(path, options, prepared);
+
+    std::string directory = path.substr(0, path.find_last_of('/'));
+    std::unordered_set<std::string> seen;
+    auto add = [&](const std::string& texture, TextureKind kind) {
+        if (!texture.empty() && seen.insert(texture).second) {
+            out.push_back({ directory + '/' + texture, kind });
+        }
+    };
+    for (const GLTFMaterialDesc& material : prepared.GetScene().Materials) {
+        add(material.Albedo, TextureKind::Albedo);
+        add(material.Normal, TextureKind::Normal);
+        add(material.PBR, TextureKind::MetallicRoughness);
+    }
+    return !out.empty();
+}
+
+/// @note(ame): one job per texture like TextureCache::Get, returns once the last one is done.
+static void PrepareAll(const std::vector<BenchTexture>& textures)
+{
+    std::vector<std::future<void>> jobs;
+    for (const BenchTexture& texture : textures) {
+        jobs.push_back(JobSystem::Submit([&texture]() {
+            ImageData data;
+            TextureCache::Prepare(texture.Path, texture.Kind, data);
+        }));
+    }
+    for (std::future<void>& job : jobs) {
+        job.get();
+    }
+}
+
+BENCH(TextureDecode)
+{
+    std::vector<BenchTexture> textures;
+    if (!CollectTextures(TEXTURE_BENCH_MODEL, textures)) {
+        return;
+    }
+
+    // Decode only: no mips, no compression, no cook
+    double synchronous = MeasureMs(1, [&]() {
+        for (const BenchTexture& texture : textures) {
+            ImageData data;
+            data.Load(texture.Path);
+        }
+    });
+    LOG_INFO("    {} textures, decoded one after the other on the main thread: {:.1f}ms", textures.size(), synchronous);
+
+    for (uint32_t threads : { 1, 2, 4, 8, 16 }) {
+        JobSystem::Exit();
+        JobSystem::Init(threads);
+
+        double ms = MeasureMs(1, [&]() {
+            std::vector<std::future<void>> jobs;
+            for (const BenchTexture& texture : textures) {
+                jobs.push_back(JobSystem::Submit([&texture]() {
+                    ImageData data;
+                    data.Load(texture.Path);
+                }));
+            }
+            for (std::future<void>& job : jobs) {
+                job.get();
+            }
+        });
+        LOG_INFO("    {} job threads: {:.1f}ms ({:.2f}x)", threads, ms, synchronous / ms);
+    }
+
+    JobSystem::Exit();
+    JobSystem::Init();
+}
+
+BENCH(TextureCook)
+{
+    std::vector<BenchTexture> textures;
+    if (!CollectTextures(TEXTURE_BENCH_MODEL, textures)) {
+        return;
+    }
+
+    // Decode, mips and compression with the cache off, then an empty cache (cold) and a full one (warm)
+    TextureCache::SetCooking(false);
+    double uncached = MeasureMs(1, [&]() { PrepareAll(textures); });
+    TextureCache::SetCooking(true);
+
+    std::error_code error;
+    std::filesystem::remove_all(std::string(TEXTURE_COOK_DIRECTORY) + "/v" + std::to_string(TEXTURE_COOK_VERSION), error);
+
+    uint32_t misses = TextureCache::GetCookMisses();
+    double cold = MeasureMs(1, [&]() { PrepareAll(textures); });
+    misses = TextureCache::GetCookMisses() - misses;
+
+    uint32_t hits = TextureCache::GetCookHits();
+    double warm = MeasureMs(3, [&]() { PrepareAll(textures); });
+    hits = (TextureCache::GetCookHits() - hits) / 3;
+
+#ifdef PATHTRACER_BLOCK_COMPRESSION
+    const char* encoding = "block compressed";
+#else
+    const char* encoding = "RGBA8";
+#endif
+    LOG_INFO("    {} textures, {}: no cache {:.1f}ms, cold {:.1f}ms ({} misses), warm {:.1f}ms ({} hits, {:.0f}x)",
+             textures.size(), encoding, uncached, cold, misses, warm, hits, cold / warm);
+}
@@ -4,15 +4,20 @@
 //
 
 #include "Shaders/Random.hlsl"
+#include "Shaders/VertexCompression.hlsl"
 
 #pragma rt_library
 
 struct Instance
 {
-    int VertexBuffer;
+    int PositionBuffer;
+    int AttributeBuffer;
     int IndexBuffer;
     int MaterialIndex;
+
     int MaterialBuffer;
+    int VertexFormat;
+    int2 Pad;
 };
 
 struct Material
@@ -23,6 +28,14 @@ struct Material
     int Pad;
 };
 
+struct VertexAttributes
+{
+    float3 Normal;
+    float2 UV;
+    float3 Tangent;
+    float3 Bitangent;
+};
+
 struct Vertex
 {
     float3 Position;
@@ -32,6 +45,38 @@ struct Vertex
     float3 Bitangent;
 };
 
+uint3 LoadTriangle(Instance instance, uint primitive)
+{
+    StructuredBuffer<uint> bIndices = ResourceDescriptorHeap[instance.IndexBuffer];
+    return uint3(bIndices[primitive * 3 + 0], bIndices[primitive * 3 + 1], bIndices[primitive * 3 + 2]);
+}
+
+Vertex LoadVertex(Instance instance, uint index)
+{
+    StructuredBuffer<float3> bPositions = ResourceDescriptorHeap[instance.PositionBuffer];
+
+    Vertex v;
+    v.Position = bPositions[index];
+    if (instance.VertexFormat == VERTEX_FORMAT_COMPACT) {
+        StructuredBuffer<CompactAttributes> bCompactAttributes = ResourceDescriptorHeap[instance.AttributeBuffer];
+        CompactAttributes packed = bCompactAttributes[index];
+
+        v.Normal = DecodeOctahedral(packed.Normal);
+        v.Tangent = DecodeOctahedral(packed.Tangent);
+        v.UV = UnpackHalf2(packed.UV);
+        v.Bitangent = cross(v.Normal, v.Tangent) * (packed.Flags & 1 ? -1.0 : 1.0);
+    } else {
+        StructuredBuffer<VertexAttributes> bAttributes = ResourceDescriptorHeap[instance.AttributeBuffer];
+        VertexAttributes attributes = bAttributes[index];
+
+        v.Normal = attributes.Normal;
+        v.UV = attributes.UV;
+        v.Tangent = attributes.Tangent;
+        v.Bitangent = attributes.Bitangent;
+    }
+    return v;
+}
+
 struct Camera
 {
     column_major float4x4 InvView;
@@ -69,10 +114,37 @@ struct RayPayload
     float3 NewDirection;
     float3 NewOrigin;
 
+    // Ray cone for texture LOD: footprint width at the ray origin and spread angle per unit of distance
+    float ConeWidth;
+    float ConeSpread;
+
     RNG rng;
 };
 
-float3 GetNormalFromNormalMap(int normalIndex, float2 uv, float3 normal, float3 tangent, float3 bitangent)
+// Ray cone LOD (Akenine-Moller et al. 2021, "Improved Shader and Texture Level of Detail Using Ray Cones").
+// Returns everything but the texture size, TextureLOD adds 0.5 * log2(width * height) for the texture being sampled.
+float RayConeLOD(float coneWidth, Vertex v0, Vertex v1, Vertex v2)
+{
+    float3 p0 = mul(ObjectToWorld3x4(), float4(v0.Position, 1.0));
+    float3 p1 = mul(ObjectToWorld3x4(), float4(v1.Position, 1.0));
+    float3 p2 = mul(ObjectToWorld3x4(), float4(v2.Position, 1.0));
+    float3 edges = cross(p1 - p0, p2 - p0);
+
+    float worldArea = length(edges);
+    float uvArea = abs((v1.UV.x - v0.UV.x) * (v2.UV.y - v0.UV.y) - (v2.UV.x - v0.UV.x) * (v1.UV.y - v0.UV.y));
+    float cosine = abs(dot(edges / max(worldArea, 1e-12), WorldRayDirection()));
+
+    return 0.5 * log2(uvArea / max(worldArea, 1e-12)) + log2(coneWidth / max(cosine, 1e-4));
+}
+
+float TextureLOD(Texture2D<float4> tTexture, float coneLod)
+{
+    uint width, height, levels;
+    tTexture.GetDimensions(0, width, height, levels);
+    return max(coneLod + 0.5 * log2(float(width * height)), 0.0);
+}
+
+float3 GetNormalFromNormalMap(int normalIndex, float2 uv, float coneLod, float3 normal, float3 tangent, float3 bitangent)
 {
     if (normalIndex == -1)
         return normalize(normal);
@@ -80,11 +152,11 @@ float3 GetNormalFromNormalMap(int normalIndex, float2 uv, float3 normal, float3
     Texture2D<float4> normalMap = ResourceDescriptorHeap[normalIndex];
     SamplerState sampler = SamplerDescriptorHeap[bConstants.nWrapSampler];
 
-    // Sample the normal map (assumes normals are stored in [0,1] range)
-    float3 normalSample = normalMap.SampleLevel(sampler, uv, 0.0).rgb;
+    // Sample the normal map (BC5, only XY are stored in [0,1] range)
+    float2 normalXY = normalMap.SampleLevel(sampler, uv, TextureLOD(normalMap, coneLod)).rg * 2.0f - 1.0f;
 
-    // Transform from [0,1] to [-1,1]
-    normalSample = normalSample * 2.0f - 1.0f;
+    // Rebuild Z from the unit length
+    float3 normalSample = float3(normalXY, sqrt(saturate(1.0f - dot(normalXY, normalXY))));
 
     // Construct the TBN matrix
     float3x3 TBN = float3x3(tangent, bitangent, normal);
@@ -95,7 +167,7 @@ float3 GetNormalFromNormalMap(int normalIndex, float2 uv, float3 normal, float3
     return worldNormal;
 }
 
-float2 GetMetallicRoughness(int pbrIndex, float2 uv)
+float2 GetMetallicRoughness(int pbrIndex, float2 uv, float coneLod)
 {
     if (pbrIndex == -1)
         return float2(0, 0.5);
@@ -103,8 +175,9 @@ float2 GetMetallicRoughness(int pbrIndex, float2 uv)
     Texture2D<float4> pbrMap = ResourceDescriptorHeap[pbrIndex];
     SamplerState sampler = SamplerDescriptorHeap[bConstants.nWrapSampler];
 
-    float4 data = pbrMap.SampleLevel(sampler, uv, 0.0);
-    return float2(data.b, data.g);
+    // Roughness in R, metallic in G (see TextureCache)
+    float4 data = pbrMap.SampleLevel(sampler, uv, TextureLOD(pbrMap, coneLod));
+    return float2(data.g, data.r);
 }
 
 [shader("raygeneration")]
@@ -143,6 +216,10 @@ void RayGeneration()
         float4 target = mul(Matrices.InvProj, float4(d.x, -d.y, 1, 1));
         vDirection = mul(Matrices.InvView, float4(normalize(target.xyz), 0)).xyz;
 
+        // One pixel's worth of angle, InvProj[1][1] is tan(fov / 2)
+        payload.ConeWidth = 0.0;
+        payload.ConeSpread = atan(2.0 * Matrices.InvProj[1][1] / dimensions.y);
+
         RayDesc ray;
         ray.TMin = 0.001;
         ray.TMax = 1000.0;
@@ -195,18 +272,11 @@ void ClosestHit(inout RayPayload Payload, in BuiltInTriangleIntersectionAttribut
     Texture2D<float4> tAlbedo = ResourceDescriptorHeap[material.AlbedoIndex];
     SamplerState sSampler = SamplerDescriptorHeap[bConstants.nWrapSampler];
 
-    StructuredBuffer<Vertex> bVertices = ResourceDescriptorHeap[instance.VertexBuffer];
-    StructuredBuffer<uint> bIndices = ResourceDescriptorHeap[instance.IndexBuffer];
-
-    uint3 indices = uint3(
-        bIndices[PrimitiveIndex() * 3 + 0],
-        bIndices[PrimitiveIndex() * 3 + 1],
-        bIndices[PrimitiveIndex() * 3 + 2]
-    );
+    uint3 indices = LoadTriangle(instance, PrimitiveIndex());
 
-    Vertex v0 = bVertices[indices.x];
-    Vertex v1 = bVertices[indices.y];
-    Vertex v2 = bVertices[indices.z];
+    Vertex v0 = LoadVertex(instance, indices.x);
+    Vertex v1 = LoadVertex(instance, indices.y);
+    Vertex v2 = LoadVertex(instance, indices.z);
 
     // Attributes
     float3 bary = float3(
@@ -230,7 +300,12 @@ void ClosestHit(inout RayPayload Payload, in BuiltInTriangleIntersectionAttribut
         Attr.barycentrics.x * v1.Bitangent +
         Attr.barycentrics.y * v2.Bitangent
     );
-    normal = GetNormalFromNormalMap(material.NormalIndex, uv, normal, tangent, bitangent);
+    // Diffuse bounces keep the spread of the camera cone, a sharper LOD than the real lobe but never a blurrier one
+    float coneWidth = Payload.ConeWidth + Payload.ConeSpread * RayTCurrent();
+    float coneLod = RayConeLOD(coneWidth, v0, v1, v2);
+    Payload.ConeWidth = coneWidth;
+
+    normal = GetNormalFromNormalMap(material.NormalIndex, uv, coneLod, normal, tangent, bitangent);
 
     // Set new dir
     float3 direction = next_unit_on_hemisphere(Payload.rng, normal);
@@ -238,7 +313,7 @@ void ClosestHit(inout RayPayload Payload, in BuiltInTriangleIntersectionAttribut
     Payload.NewOrigin = hitPos + (normal * 0.001);
     
     // Shade
-    float3 albedo = tAlbedo.SampleLevel(sSampler, uv, 0.0).rgb;
+    float3 albedo = tAlbedo.SampleLevel(sSampler, uv, TextureLOD(tAlbedo, coneLod)).rgb;
     float cosTheta = dot(normal, direction);
     float pdf = cosTheta / 3.14159;
     float3 f_r = albedo / 3.14159;
@@ -269,18 +344,11 @@ void AnyHit(inout RayPayload Payload, in BuiltInTriangleIntersectionAttributes A
     Texture2D<float4> tAlbedo = ResourceDescriptorHeap[material.AlbedoIndex];
     SamplerState sSampler = SamplerDescriptorHeap[bConstants.nWrapSampler];
 
-    StructuredBuffer<Vertex> bVertices = ResourceDescriptorHeap[instance.VertexBuffer];
-    StructuredBuffer<uint> bIndices = ResourceDescriptorHeap[instance.IndexBuffer];
-
-    uint3 indices = uint3(
-        bIndices[PrimitiveIndex() * 3 + 0],
-        bIndices[PrimitiveIndex() * 3 + 1],
-        bIndices[PrimitiveIndex() * 3 + 2]
-    );
+    uint3 indices = LoadTriangle(instance, PrimitiveIndex());
 
-    Vertex v0 = bVertices[indices.x];
-    Vertex v1 = bVertices[indices.y];
-    Vertex v2 = bVertices[indices.z];
+    Vertex v0 = LoadVertex(instance, indices.x);
+    Vertex v1 = LoadVertex(instance, indices.y);
+    Vertex v2 = LoadVertex(instance, indices.z);
 
     float3 bary = float3(
         1.0 - Attr.barycentrics.x - Attr.barycentrics.y,
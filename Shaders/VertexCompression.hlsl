@@ -0,0 +1,39 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-14 19:02:17
+//
+
+// Decode side of Source/Util/VertexQuantization.cpp, keep both in sync.
+
+#define VERTEX_FORMAT_FULL 0
+#define VERTEX_FORMAT_COMPACT 1
+
+struct CompactAttributes
+{
+    uint Normal;
+    uint Tangent;
+    uint UV;
+    uint Flags;
+};
+
+float2 UnpackSnorm16x2(uint packed)
+{
+    int2 values = int2(packed << 16, packed) >> 16;
+    return max(float2(values) / 32767.0, -1.0);
+}
+
+float3 DecodeOctahedral(uint packed)
+{
+    float2 f = UnpackSnorm16x2(packed);
+    float3 n = float3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+
+    float t = saturate(-n.z);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+float2 UnpackHalf2(uint packed)
+{
+    return float2(f16tof32(packed), f16tof32(packed >> 16));
+}
@@ -4,6 +4,7 @@
 //
 
 #include "Application.hpp"
+#include "Cache/TextureCache.hpp"
 
 #include <imgui.h>
 
@@ -16,8 +17,8 @@ Application::Application()
 
     mRenderer = std::make_shared<Renderer>();
 
-    mScene.PushEntity(glm::mat4(1.0f), "Assets/Sponza/Sponza.gltf");
-    mScene.Build();
+    // The first frames render an empty scene, Sponza is committed by Scene::Update once it's decoded
+    mScene.PushEntityAsync(glm::mat4(1.0f), "Assets/Sponza/Sponza.gltf");
 
     Uploader::Flush();
 }
@@ -35,6 +36,9 @@ void Application::Run()
         float dt = (now - mStart) / 1000.0f;
         mStart = now;
 
+        // Frame boundary: nothing from the previous frame is being recorded anymore
+        mScene.Update();
+
         // Begin camera
         mCamera.Begin();
         mScene.CamInfo.Position = mCamera.Position();
@@ -96,6 +100,19 @@ void Application::UI()
     ImGui::Text("Pathtracer : a DXR pathtracer by Amélie Heinrich");
     ImGui::Text("GPU: %s", RHI::GetDevice()->GetDeviceName().c_str());
     ImGui::Separator();
+    if (mScene.GetPendingLoadCount() > 0) {
+        ImGui::Text("Loading %u model(s)...", mScene.GetPendingLoadCount());
+        ImGui::ProgressBar(mScene.GetLoadProgress());
+        ImGui::Separator();
+    }
+    if (TextureCache::GetPendingCount() > 0) {
+        ImGui::Text("Decoding %u texture(s)...", TextureCache::GetPendingCount());
+        ImGui::Separator();
+    }
+    const TextureCacheStats& textures = TextureCache::GetStats();
+    ImGui::Text("Textures: %u resident, %.1f / %.1f MB", textures.ResidentCount, textures.ResidentBytes / 1048576.0, textures.Budget / 1048576.0);
+    ImGui::Text("Texture evictions: %u, hit rate %.0f%%", textures.Evictions, textures.HitRate() * 100.0f);
+    ImGui::Separator();
 
     mRenderer->UI();
 
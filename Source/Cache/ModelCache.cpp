@@ -0,0 +1,58 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-21 09:55:40
+//
+
+#include "ModelCache.hpp"
+#include "Util/Hash.hpp"
+
+std::unordered_map<std::string, std::weak_ptr<GLTF>> ModelCache::mModels;
+
+std::string ModelCache::Key(const std::string& path, const GLTFLoadOptions& options)
+{
+    // Parallel/UseCook only change how the model is loaded, not what comes out of it
+    uint32_t layout = (options.CompactVertices ? 1 : 0) | (options.BuildClusters ? 2 : 0);
+    uint64_t key = HashCombine(options.CookKey(), Hash64(&layout, sizeof(layout)));
+    return path + "|" + std::to_string(key);
+}
+
+GLTFHandle ModelCache::Find(const std::string& path, const GLTFLoadOptions& options)
+{
+    auto it = mModels.find(Key(path, options));
+    if (it == mModels.end()) {
+        return nullptr;
+    }
+
+    GLTFHandle model = it->second.lock();
+    if (!model) {
+        mModels.erase(it);
+    }
+    return model;
+}
+
+GLTFHandle ModelCache::Get(const std::string& path, const GLTFLoadOptions& options, bool* created)
+{
+    GLTFHandle model = Find(path, options);
+    if (created) {
+        *created = !model;
+    }
+    if (model) {
+        LOG_INFO("{}: already loaded, sharing it ({} references)", path, model.use_count());
+        return model;
+    }
+
+    model = std::make_shared<GLTF>();
+    model->Load(path, options);
+    Insert(path, options, model);
+    return model;
+}
+
+void ModelCache::Insert(const std::string& path, const GLTFLoadOptions& options, const GLTFHandle& model)
+{
+    mModels[Key(path, options)] = model;
+}
+
+void ModelCache::Clear()
+{
+    mModels.clear();
+}
@@ -0,0 +1,37 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-21 09:42:17
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+#include <unordered_map>
+
+#include "Model.hpp"
+
+/*
+    Models shared between entities, keyed by path and the load options that change what gets built.
+    Entries are weak: the entities holding a GLTFHandle own the model, the last one to go frees its buffers, BLASes and views.
+    Placing the same asset again costs a handle copy, only the per entity instances are added in Scene::Build.
+    Main thread only, like TextureCache.
+*/
+
+using GLTFHandle = std::shared_ptr<GLTF>;
+
+class ModelCache
+{
+public:
+    /// @note(ame): live model loaded from path with matching options, nullptr if there is none.
+    static GLTFHandle Find(const std::string& path, const GLTFLoadOptions& options = {});
+    /// @note(ame): Find, loading synchronously on a miss. created is set when this call did the load.
+    static GLTFHandle Get(const std::string& path, const GLTFLoadOptions& options = {}, bool* created = nullptr);
+    /// @note(ame): registers a model that was loaded outside the cache (Prepare/Finish through Scene::PushEntityAsync).
+    static void Insert(const std::string& path, const GLTFLoadOptions& options, const GLTFHandle& model);
+    static void Clear();
+
+    /// @note(ame): two loads with the same key build the same model.
+    static std::string Key(const std::string& path, const GLTFLoadOptions& options);
+private:
+    static std::unordered_map<std::string, std::weak_ptr<GLTF>> mModels;
+};
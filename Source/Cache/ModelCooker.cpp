@@ -0,0 +1,413 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-13 12:10:27
+//
+
+#include "ModelCooker.hpp"
+#include "Util/Hash.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+static constexpr uint32_t COOK_MAGIC = 0x4B434D50; // 'PMCK'
+static constexpr uint32_t COOK_NO_STRING = UINT32_MAX;
+static constexpr uint64_t COOK_ALIGNMENT = 16;
+
+struct CookHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t SourceHash;
+
+    uint32_t VertexStride;
+    uint32_t DependencyCount;
+    uint32_t NodeCount;
+    uint32_t MeshCount;
+    uint32_t PrimitiveCount;
+    uint32_t MaterialCount;
+    uint64_t OptionsKey;
+
+    uint64_t StringsOffset;
+    uint64_t StringsSize;
+    uint64_t DependenciesOffset;
+    uint64_t NodesOffset;
+    uint64_t MeshesOffset;
+    uint64_t PrimitivesOffset;
+    uint64_t MaterialsOffset;
+    uint64_t GeometryOffset;
+    uint64_t FileSize;
+};
+
+struct CookNode
+{
+    uint32_t Name;
+    int32_t Parent;
+    int32_t Mesh;
+    uint32_t Pad;
+    glm::mat4 Transform;
+};
+
+struct CookMesh
+{
+    uint32_t FirstPrimitive;
+    uint32_t PrimitiveCount;
+};
+
+struct CookPrimitive
+{
+    uint64_t VertexOffset;
+    uint64_t IndexOffset;
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+    int32_t Material;
+    uint32_t LODCount;
+    uint64_t LODIndexOffset;
+    uint64_t LODLevelOffset;
+    uint32_t LODIndexCount;
+    uint32_t Pad;
+};
+
+struct CookMaterial
+{
+    uint32_t Albedo;
+    uint32_t Normal;
+    uint32_t PBR;
+    uint32_t AlphaTested;
+};
+
+static uint64_t Align(uint64_t value)
+{
+    return (value + COOK_ALIGNMENT - 1) & ~(COOK_ALIGNMENT - 1);
+}
+
+template<typename T>
+static const T* Section(const MappedFile& file, uint64_t offset, uint64_t count)
+{
+    if (offset > file.Size() || count * sizeof(T) > file.Size() - offset) {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(file.Data() + offset);
+}
+
+/// @note(ame): true if every index addresses one of vertexCount vertices. Max then compare, so the loop vectorizes.
+static bool IndicesInRange(const uint32_t* indices, uint64_t count, uint32_t vertexCount)
+{
+    uint32_t largest = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        largest = std::max(largest, indices[i]);
+    }
+    return count == 0 || largest < vertexCount;
+}
+
+std::string ModelCooker::GetCookPath(const std::string& path, const GLTFLoadOptions& options)
+{
+    char key[24];
+    snprintf(key, sizeof(key), ".%016llx.cook", static_cast<unsigned long long>(options.CookKey()));
+    return path + key;
+}
+
+bool ModelCooker::HashSources(const std::string& path, const std::vector<std::string>& dependencies, uint64_t& hash)
+{
+    std::string directory = path.substr(0, path.find_last_of('/'));
+
+    MappedFile source;
+    if (!source.Open(path)) {
+        return false;
+    }
+    hash = Hash64(source.Data(), source.Size(), MODEL_COOK_VERSION);
+
+    for (auto& dependency : dependencies) {
+        MappedFile file;
+        if (!file.Open(directory + '/' + dependency)) {
+            return false;
+        }
+        hash = HashCombine(hash, Hash64(file.Data(), file.Size()));
+    }
+    return true;
+}
+
+bool ModelCooker::Read(const std::string& path, const GLTFLoadOptions& options, ModelCook& out)
+{
+    MappedFile& file = out.File;
+    if (!file.Open(GetCookPath(path, options))) {
+        return false;
+    }
+
+    const CookHeader* header = Section<CookHeader>(file, 0, 1);
+    if (!header || header->Magic != COOK_MAGIC || header->Version != MODEL_COOK_VERSION || header->VertexStride != sizeof(Vertex) || header->FileSize != file.Size()) {
+        LOG_WARN("Cook for {} is invalid or out of date, rebuilding", path);
+        file.Close();
+        return false;
+    }
+    if (header->OptionsKey != options.CookKey()) {
+        LOG_INFO("Cook for {} was built with different load options, rebuilding", path);
+        file.Close();
+        return false;
+    }
+
+    const char* strings = Section<char>(file, header->StringsOffset, header->StringsSize);
+    const uint32_t* dependencies = Section<uint32_t>(file, header->DependenciesOffset, header->DependencyCount);
+    const CookNode* nodes = Section<CookNode>(file, header->NodesOffset, header->NodeCount);
+    const CookMesh* meshes = Section<CookMesh>(file, header->MeshesOffset, header->MeshCount);
+    const CookPrimitive* primitives = Section<CookPrimitive>(file, header->PrimitivesOffset, header->PrimitiveCount);
+    const CookMaterial* materials = Section<CookMaterial>(file, header->MaterialsOffset, header->MaterialCount);
+    if (!strings || !dependencies || !nodes || !meshes || !primitives || !materials || header->StringsSize == 0 || strings[header->StringsSize - 1] != '\0') {
+        LOG_WARN("Cook for {} is truncated, rebuilding", path);
+        file.Close();
+        return false;
+    }
+
+    auto getString = [&](uint32_t offset) -> std::string {
+        return offset < header->StringsSize ? std::string(strings + offset) : std::string();
+    };
+
+    GLTFSceneDesc& desc = out.Scene;
+    for (uint32_t i = 0; i < header->DependencyCount; i++) {
+        desc.Dependencies.push_back(getString(dependencies[i]));
+    }
+
+    // Stale if the .gltf or any of its buffers changed since the cook was written
+    uint64_t hash = 0;
+    if (!HashSources(path, desc.Dependencies, hash) || hash != header->SourceHash) {
+        LOG_INFO("Cook for {} is stale, rebuilding", path);
+        desc = {};
+        file.Close();
+        return false;
+    }
+
+    desc.Nodes.resize(header->NodeCount);
+    for (uint32_t i = 0; i < header->NodeCount; i++) {
+        desc.Nodes[i].Name = getString(nodes[i].Name);
+        desc.Nodes[i].Parent = nodes[i].Parent;
+        desc.Nodes[i].Mesh = nodes[i].Mesh;
+        desc.Nodes[i].Transform = nodes[i].Transform;
+
+        // GLTF::Commit builds its flat hierarchy in one pass, parents have to come first
+        if (nodes[i].Parent < -1 || nodes[i].Parent >= static_cast<int>(i) || nodes[i].Mesh < -1 || nodes[i].Mesh >= static_cast<int>(header->MeshCount)) {
+            LOG_WARN("Cook for {} has a malformed hierarchy, rebuilding", path);
+            desc = {};
+            file.Close();
+            return false;
+        }
+    }
+
+    desc.Meshes.resize(header->MeshCount);
+    for (uint32_t i = 0; i < header->MeshCount; i++) {
+        desc.Meshes[i].FirstPrimitive = meshes[i].FirstPrimitive;
+        desc.Meshes[i].PrimitiveCount = meshes[i].PrimitiveCount;
+
+        // GLTF::Commit indexes Primitives[FirstPrimitive + j] straight from these
+        if (static_cast<uint64_t>(meshes[i].FirstPrimitive) + meshes[i].PrimitiveCount > header->PrimitiveCount) {
+            LOG_WARN("Cook for {} has a malformed mesh table, rebuilding", path);
+            desc = {};
+            file.Close();
+            return false;
+        }
+    }
+
+    desc.Primitives.resize(header->PrimitiveCount);
+    for (uint32_t i = 0; i < header->PrimitiveCount; i++) {
+        const CookPrimitive& primitive = primitives[i];
+
+        desc.Primitives[i].Vertices = Section<Vertex>(file, primitive.VertexOffset, primitive.VertexCount);
+        desc.Primitives[i].Indices = Section<uint32_t>(file, primitive.IndexOffset, primitive.IndexCount);
+        desc.Primitives[i].VertexCount = primitive.VertexCount;
+        desc.Primitives[i].IndexCount = primitive.IndexCount;
+        desc.Primitives[i].Material = primitive.Material;
+        desc.Primitives[i].LODIndices = Section<uint32_t>(file, primitive.LODIndexOffset, primitive.LODIndexCount);
+        desc.Primitives[i].LODLevels = Section<LODLevel>(file, primitive.LODLevelOffset, primitive.LODCount);
+        desc.Primitives[i].LODIndexCount = primitive.LODIndexCount;
+        desc.Primitives[i].LODCount = primitive.LODCount;
+
+        bool lodsValid = !primitive.LODCount || (desc.Primitives[i].LODIndices && desc.Primitives[i].LODLevels);
+        for (uint32_t j = 0; lodsValid && j < primitive.LODCount; j++) {
+            const LODLevel& level = desc.Primitives[i].LODLevels[j];
+            lodsValid = static_cast<uint64_t>(level.FirstIndex) + level.IndexCount <= primitive.LODIndexCount;
+        }
+
+        if ((primitive.VertexCount && !desc.Primitives[i].Vertices) || (primitive.IndexCount && !desc.Primitives[i].Indices) || !lodsValid) {
+            LOG_WARN("Cook for {} is truncated, rebuilding", path);
+            desc = {};
+            file.Close();
+            return false;
+        }
+
+        // Materials are looked up by index and indices go to the GPU as is, both have to stay in range
+        bool materialValid = primitive.Material >= -1 && primitive.Material < static_cast<int64_t>(header->MaterialCount);
+        bool indicesValid = IndicesInRange(desc.Primitives[i].Indices, primitive.IndexCount, primitive.VertexCount) && IndicesInRange(desc.Primitives[i].LODIndices, primitive.LODIndexCount, primitive.VertexCount);
+        if (!materialValid || !indicesValid) {
+            LOG_WARN("Cook for {} has a malformed primitive, rebuilding", path);
+            desc = {};
+            file.Close();
+            return false;
+        }
+    }
+
+    desc.Materials.resize(header->MaterialCount);
+    for (uint32_t i = 0; i < header->MaterialCount; i++) {
+        desc.Materials[i].Albedo = getString(materials[i].Albedo);
+        desc.Materials[i].Normal = getString(materials[i].Normal);
+        desc.Materials[i].PBR = getString(materials[i].PBR);
+        desc.Materials[i].AlphaTested = materials[i].AlphaTested != 0;
+    }
+
+    return true;
+}
+
+void ModelCooker::Write(const std::string& path, const GLTFLoadOptions& options, const GLTFSceneDesc& desc)
+{
+    CookHeader header = {};
+    header.Magic = COOK_MAGIC;
+    header.Version = MODEL_COOK_VERSION;
+    header.VertexStride = sizeof(Vertex);
+    header.DependencyCount = static_cast<uint32_t>(desc.Dependencies.size());
+    header.NodeCount = static_cast<uint32_t>(desc.Nodes.size());
+    header.MeshCount = static_cast<uint32_t>(desc.Meshes.size());
+    header.PrimitiveCount = static_cast<uint32_t>(desc.Primitives.size());
+    header.MaterialCount = static_cast<uint32_t>(desc.Materials.size());
+    header.OptionsKey = options.CookKey();
+
+    if (!HashSources(path, desc.Dependencies, header.SourceHash)) {
+        LOG_WARN("Failed to hash sources of {}, not writing a cook", path);
+        return;
+    }
+
+    // String table
+    std::vector<char> strings;
+    auto pushString = [&](const std::string& string) -> uint32_t {
+        if (string.empty()) {
+            return COOK_NO_STRING;
+        }
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), string.begin(), string.end());
+        strings.push_back('\0');
+        return offset;
+    };
+    strings.push_back('\0');
+
+    std::vector<uint32_t> dependencies;
+    for (auto& dependency : desc.Dependencies) {
+        dependencies.push_back(pushString(dependency));
+    }
+
+    std::vector<CookNode> nodes(desc.Nodes.size());
+    for (size_t i = 0; i < desc.Nodes.size(); i++) {
+        nodes[i].Name = pushString(desc.Nodes[i].Name);
+        nodes[i].Parent = desc.Nodes[i].Parent;
+        nodes[i].Mesh = desc.Nodes[i].Mesh;
+        nodes[i].Transform = desc.Nodes[i].Transform;
+    }
+
+    std::vector<CookMesh> meshes(desc.Meshes.size());
+    for (size_t i = 0; i < desc.Meshes.size(); i++) {
+        meshes[i].FirstPrimitive = desc.Meshes[i].FirstPrimitive;
+        meshes[i].PrimitiveCount = desc.Meshes[i].PrimitiveCount;
+    }
+
+    std::vector<CookMaterial> materials(desc.Materials.size());
+    for (size_t i = 0; i < desc.Materials.size(); i++) {
+        materials[i].Albedo = pushString(desc.Materials[i].Albedo);
+        materials[i].Normal = pushString(desc.Materials[i].Normal);
+        materials[i].PBR = pushString(desc.Materials[i].PBR);
+        materials[i].AlphaTested = desc.Materials[i].AlphaTested;
+    }
+
+    // Layout
+    uint64_t offset = Align(sizeof(CookHeader));
+    header.StringsOffset = offset;
+    header.StringsSize = strings.size();
+    offset = Align(offset + strings.size());
+    header.DependenciesOffset = offset;
+    offset = Align(offset + dependencies.size() * sizeof(uint32_t));
+    header.NodesOffset = offset;
+    offset = Align(offset + nodes.size() * sizeof(CookNode));
+    header.MeshesOffset = offset;
+    offset = Align(offset + meshes.size() * sizeof(CookMesh));
+    header.PrimitivesOffset = offset;
+    offset = Align(offset + desc.Primitives.size() * sizeof(CookPrimitive));
+    header.MaterialsOffset = offset;
+    offset = Align(offset + materials.size() * sizeof(CookMaterial));
+    header.GeometryOffset = offset;
+
+    std::vector<CookPrimitive> primitives(desc.Primitives.size());
+    for (size_t i = 0; i < desc.Primitives.size(); i++) {
+        const GLTFPrimitiveDesc& primitive = desc.Primitives[i];
+
+        primitives[i].VertexCount = primitive.VertexCount;
+        primitives[i].IndexCount = primitive.IndexCount;
+        primitives[i].Material = primitive.Material;
+        primitives[i].VertexOffset = offset;
+        offset = Align(offset + primitive.VertexCount * sizeof(Vertex));
+        primitives[i].IndexOffset = offset;
+        offset = Align(offset + primitive.IndexCount * sizeof(uint32_t));
+        primitives[i].LODCount = primitive.LODCount;
+        primitives[i].LODIndexCount = primitive.LODIndexCount;
+        primitives[i].LODLevelOffset = offset;
+        offset = Align(offset + primitive.LODCount * sizeof(LODLevel));
+        primitives[i].LODIndexOffset = offset;
+        offset = Align(offset + primitive.LODIndexCount * sizeof(uint32_t));
+    }
+    header.FileSize = offset;
+
+    // Write to a temporary and swap it in, so a crash never leaves a half written cook behind.
+    // Loads of one asset run Prepare concurrently on the job system, every writer needs its own temporary.
+    static std::atomic<uint32_t> writeCounter = 0;
+    std::string cookPath = GetCookPath(path, options);
+    std::string tempPath = cookPath + '.' + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + '.' + std::to_string(writeCounter++) + ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            LOG_WARN("Failed to open {} for writing", tempPath);
+            return;
+        }
+
+        uint64_t written = 0;
+        auto write = [&](const void* data, uint64_t size, uint64_t at) {
+            static const char zeroes[COOK_ALIGNMENT] = {};
+            while (written < at) {
+                uint64_t padding = std::min<uint64_t>(at - written, COOK_ALIGNMENT);
+                stream.write(zeroes, padding);
+                written += padding;
+            }
+            if (size > 0) {
+                stream.write(static_cast<const char*>(data), size);
+                written += size;
+            }
+        };
+
+        write(&header, sizeof(header), 0);
+        write(strings.data(), strings.size(), header.StringsOffset);
+        write(dependencies.data(), dependencies.size() * sizeof(uint32_t), header.DependenciesOffset);
+        write(nodes.data(), nodes.size() * sizeof(CookNode), header.NodesOffset);
+        write(meshes.data(), meshes.size() * sizeof(CookMesh), header.MeshesOffset);
+        write(primitives.data(), primitives.size() * sizeof(CookPrimitive), header.PrimitivesOffset);
+        write(materials.data(), materials.size() * sizeof(CookMaterial), header.MaterialsOffset);
+        for (size_t i = 0; i < desc.Primitives.size(); i++) {
+            write(desc.Primitives[i].Vertices, primitives[i].VertexCount * sizeof(Vertex), primitives[i].VertexOffset);
+            write(desc.Primitives[i].Indices, primitives[i].IndexCount * sizeof(uint32_t), primitives[i].IndexOffset);
+            write(desc.Primitives[i].LODLevels, primitives[i].LODCount * sizeof(LODLevel), primitives[i].LODLevelOffset);
+            write(desc.Primitives[i].LODIndices, primitives[i].LODIndexCount * sizeof(uint32_t), primitives[i].LODIndexOffset);
+        }
+        write(nullptr, 0, header.FileSize);
+
+        if (!stream.good()) {
+            LOG_WARN("Failed to write {}", tempPath);
+            stream.close();
+
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cookPath, error);
+    if (error) {
+        LOG_WARN("Failed to move {} to {}: {}", tempPath, cookPath, error.message());
+        std::filesystem::remove(tempPath, error);
+    }
+}
@@ -0,0 +1,39 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-13 12:03:44
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "Model.hpp"
+#include "Util/MappedFile.hpp"
+
+/*
+    Binary cook of a decoded model, written next to the asset as <model>.<key>.cook, key being GLTFLoadOptions::CookKey in hex.
+    It stores the final vertex/index arrays, the flattened node hierarchy and the material table, keyed by a hash of the .gltf and its buffers.
+    On a warm start the cook is mapped and the arrays go straight to the uploader, cgltf never runs.
+    Load options that change the geometry (GLTFLoadOptions::CookKey) get their own file, switching between them never overwrites a cook.
+    Bump MODEL_COOK_VERSION whenever the layout or anything that feeds it (Vertex, decode, welding, tangents, reordering, LODs) changes.
+*/
+
+#define MODEL_COOK_VERSION 4
+
+/// @note(ame): Scene points into File, keep it alive until the model has been committed.
+struct ModelCook
+{
+    MappedFile File;
+    GLTFSceneDesc Scene;
+};
+
+class ModelCooker
+{
+public:
+    static bool Read(const std::string& path, const GLTFLoadOptions& options, ModelCook& out);
+    static void Write(const std::string& path, const GLTFLoadOptions& options, const GLTFSceneDesc& desc);
+
+    static std::string GetCookPath(const std::string& path, const GLTFLoadOptions& options);
+private:
+    static bool HashSources(const std::string& path, const std::vector<std::string>& dependencies, uint64_t& hash);
+};
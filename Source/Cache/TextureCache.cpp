@@ -4,35 +4,359 @@
 //
 
 #include "TextureCache.hpp"
+#include "TextureCooker.hpp"
+#include "Util/BlockCompression.hpp"
+#include "Util/Hash.hpp"
+#include "Util/ImageInfo.hpp"
+#include "Util/JobSystem.hpp"
+#include "Util/MipGenerator.hpp"
 
-std::unordered_map<std::string, std::shared_ptr<Texture>> TextureCache::mTextures;
+#include <algorithm>
 
-std::shared_ptr<Texture> TextureCache::Get(const std::string& path)
+std::unordered_map<std::string, TextureCache::CachedTexture> TextureCache::mTextures;
+std::vector<TextureCache::PendingTexture> TextureCache::mPending;
+std::unordered_set<const Texture*> TextureCache::mReady;
+TextureCompression TextureCache::mCompression = TextureCompression::Quality;
+bool TextureCache::mCooking = true;
+std::atomic<uint32_t> TextureCache::mCookHits = 0;
+std::atomic<uint32_t> TextureCache::mCookMisses = 0;
+std::chrono::high_resolution_clock::time_point TextureCache::mBatchStart;
+uint32_t TextureCache::mBatchCount = 0;
+uint64_t TextureCache::mBudget = TEXTURE_BUDGET_DEFAULT;
+uint64_t TextureCache::mFrame = 0;
+bool TextureCache::mOverBudget = false;
+TextureCacheStats TextureCache::mStats = {};
+
+TextureCache::Encoding TextureCache::ChooseEncoding(TextureKind kind, uint32_t width, uint32_t height)
+{
+    Encoding encoding;
+    encoding.Format = TextureFormat::RGBA8;
+    encoding.ViewFormat = kind == TextureKind::Albedo ? TextureFormat::RGBA8_sRGB : TextureFormat::RGBA8;
+    encoding.Compressed = false;
+    encoding.Block = BlockFormat::BC7;
+
+#ifndef PATHTRACER_BLOCK_COMPRESSION
+    // Built without the block_compression option, Oslo isn't known to have BC formats
+    return encoding;
+#else
+    // The top level has to be made of whole blocks, lower levels may have partial ones
+    if (mCompression == TextureCompression::None || width % 4 != 0 || height % 4 != 0) {
+        return encoding;
+    }
+
+    bool small = mCompression == TextureCompression::Size;
+    encoding.Compressed = true;
+    switch (kind) {
+        case TextureKind::Albedo:
+            encoding.Block = small ? BlockFormat::BC1 : BlockFormat::BC7;
+            encoding.Format = small ? TextureFormat::BC1 : TextureFormat::BC7;
+            encoding.ViewFormat = small ? TextureFormat::BC1_sRGB : TextureFormat::BC7_sRGB;
+            break;
+        case TextureKind::Normal:
+        case TextureKind::MetallicRoughness:
+            encoding.Block = BlockFormat::BC5;
+            encoding.Format = TextureFormat::BC5;
+            encoding.ViewFormat = TextureFormat::BC5;
+            break;
+        default:
+            encoding.Block = small ? BlockFormat::BC1 : BlockFormat::BC7;
+            encoding.Format = small ? TextureFormat::BC1 : TextureFormat::BC7;
+            encoding.ViewFormat = encoding.Format;
+            break;
+    }
+    return encoding;
+#endif
+}
+
+uint64_t TextureCache::SettingsKey(TextureKind kind, const Encoding& encoding)
+{
+    uint32_t settings[4] = {
+        static_cast<uint32_t>(kind),
+        static_cast<uint32_t>(encoding.Format),
+        encoding.Compressed,
+        static_cast<uint32_t>(encoding.Block)
+    };
+    return Hash64(settings, sizeof(settings));
+}
+
+size_t TextureCache::ProcessedSize(const Encoding& encoding, uint32_t width, uint32_t height)
+{
+    uint32_t levels = MipLevelCount(width, height);
+    if (!encoding.Compressed) {
+        return MipChainSize(width, height, levels);
+    }
+
+    size_t size = 0;
+    for (uint32_t i = 0; i < levels; i++) {
+        size += BlockCompressedSize(std::max(width >> i, 1u), std::max(height >> i, 1u), encoding.Block);
+    }
+    return size;
+}
+
+void TextureCache::Process(ImageData& data, TextureKind kind, const Encoding& encoding)
+{
+    // Roughness and metallic go to R and G so BC5 keeps both, uncompressed textures get the same layout for the shader's sake
+    if (kind == TextureKind::MetallicRoughness) {
+        for (size_t i = 0; i + 3 < data.Pixels.size(); i += 4) {
+            data.Pixels[i + 0] = data.Pixels[i + 1];
+            data.Pixels[i + 1] = data.Pixels[i + 2];
+        }
+    }
+
+    MipFilter filter = MipFilter::Linear;
+    if (kind == TextureKind::Albedo) {
+        filter = MipFilter::SRGB;
+    } else if (kind == TextureKind::Normal) {
+        filter = MipFilter::Normal;
+    }
+    GenerateMipChain(data.Pixels, data.Width, data.Height, filter);
+
+    if (encoding.Compressed) {
+        std::vector<uint8_t> blocks;
+        CompressMipChain(data.Pixels.data(), data.Width, data.Height, MipLevelCount(data.Width, data.Height), encoding.Block, blocks);
+        data.Pixels = std::move(blocks);
+    }
+}
+
+void TextureCache::Decode(const std::string& path, TextureKind kind, const Encoding& encoding, uint32_t width, uint32_t height, bool cooking, ImageData& data)
 {
-    if (mTextures.find(path) == mTextures.end()) {
-        ImageData data;
+    uint64_t sourceHash = 0;
+    uint64_t settingsKey = SettingsKey(kind, encoding);
+    bool cooked = cooking && TextureCooker::HashSource(path, sourceHash);
+    if (cooked) {
+        TextureCook cook;
+        if (TextureCooker::Read(sourceHash, settingsKey, cook)) {
+            if (cook.Width == width && cook.Height == height && cook.Levels == MipLevelCount(width, height) && cook.Size == ProcessedSize(encoding, width, height)) {
+                data.Width = width;
+                data.Height = height;
+                data.Pixels.assign(cook.Pixels, cook.Pixels + cook.Size);
+                mCookHits++;
+                return;
+            }
+            LOG_WARN("Texture cook of {} doesn't match the image, rebuilding", path);
+        }
+    }
+    mCookMisses++;
+
+    data.Load(path);
+    // A size mismatch is reported by Upload, there's nothing to process for it
+    if (data.Width == width && data.Height == height) {
+        Process(data, kind, encoding);
+        if (cooked) {
+            TextureCooker::Write(sourceHash, settingsKey, width, height, MipLevelCount(width, height), data.Pixels);
+        }
+    }
+}
+
+void TextureCache::Prepare(const std::string& path, TextureKind kind, ImageData& data)
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (!ReadImageSize(path, width, height)) {
         data.Load(path);
+        Process(data, kind, ChooseEncoding(kind, data.Width, data.Height));
+        return;
+    }
+    Decode(path, kind, ChooseEncoding(kind, width, height), width, height, mCooking, data);
+}
+
+std::shared_ptr<Texture> TextureCache::Get(const std::string& path, TextureKind kind, TextureFormat* viewFormat)
+{
+    auto it = mTextures.find(path);
+    if (it != mTextures.end()) {
+        it->second.LastUse = mFrame;
+        mStats.Hits++;
+        if (viewFormat) {
+            *viewFormat = it->second.ViewFormat;
+        }
+        return it->second.Texture;
+    }
+    mStats.Misses++;
+
+    TextureDesc desc;
+    desc.Depth = 1;
+    desc.Name = path;
+    desc.Usage = TextureUsage::ShaderResource;
+
+    std::shared_ptr<ImageData> data = std::make_shared<ImageData>();
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (!ReadImageSize(path, width, height)) {
+        LOG_WARN("{}: unknown image header, decoding it on the main thread", path);
+        data->Load(path);
+
+        Encoding encoding = ChooseEncoding(kind, data->Width, data->Height);
+        desc.Width = data->Width;
+        desc.Height = data->Height;
+        desc.Levels = MipLevelCount(data->Width, data->Height);
+        desc.Format = encoding.Format;
+        Process(*data, kind, encoding);
+
+        Insert(path, std::make_shared<Texture>(desc), encoding.ViewFormat, data->Pixels.size());
+        Uploader::EnqueueTextureUpload(data->Pixels, mTextures[path].Texture);
+        mReady.insert(mTextures[path].Texture.get());
+        if (viewFormat) {
+            *viewFormat = encoding.ViewFormat;
+        }
+        return mTextures[path].Texture;
+    }
+
+    Encoding encoding = ChooseEncoding(kind, width, height);
+    desc.Width = width;
+    desc.Height = height;
+    desc.Levels = MipLevelCount(width, height);
+    desc.Format = encoding.Format;
 
-        TextureDesc desc;
-        desc.Width = data.Width;
-        desc.Height = data.Height;
-        desc.Depth = 1;
-        desc.Levels = 1;
-        desc.Name = path;
-        desc.Usage = TextureUsage::ShaderResource;
-        desc.Format = TextureFormat::RGBA8;
-        
-        mTextures[path] = std::make_shared<Texture>(desc);
-        Uploader::EnqueueTextureUpload(data.Pixels, mTextures[path]);
-        return mTextures[path];
-    } else {
-        return mTextures[path];
+    // The job only owns its ImageData, the texture is created here and uploaded by Update
+    PendingTexture pending;
+    pending.Path = path;
+    pending.Width = width;
+    pending.Height = height;
+    pending.Texture = std::make_shared<Texture>(desc);
+    pending.Data = data;
+    pending.Job = JobSystem::Submit([data, path, width, height, kind, encoding, cooking = mCooking]() {
+        Decode(path, kind, encoding, width, height, cooking, *data);
+    });
+
+    if (mPending.empty()) {
+        mBatchStart = std::chrono::high_resolution_clock::now();
+        mBatchCount = 0;
+    }
+    mBatchCount++;
+
+    Insert(path, pending.Texture, encoding.ViewFormat, ProcessedSize(encoding, width, height));
+    mPending.push_back(std::move(pending));
+    if (viewFormat) {
+        *viewFormat = encoding.ViewFormat;
+    }
+    return mTextures[path].Texture;
+}
+
+void TextureCache::Upload(PendingTexture& pending)
+{
+    pending.Job.get();
+
+    if (pending.Data->Width != pending.Width || pending.Data->Height != pending.Height) {
+        LOG_ERROR("{}: decoded as {}x{} but the header says {}x{}, skipping upload", pending.Path, pending.Data->Width, pending.Data->Height, pending.Width, pending.Height);
+        return;
+    }
+    Uploader::EnqueueTextureUpload(pending.Data->Pixels, pending.Texture);
+    mReady.insert(pending.Texture.get());
+}
+
+bool TextureCache::Update()
+{
+    bool uploaded = false;
+    for (auto it = mPending.begin(); it != mPending.end();) {
+        if (it->Job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+
+        Upload(*it);
+        uploaded = true;
+        it = mPending.erase(it);
+    }
+
+    if (uploaded && mPending.empty()) {
+        EndBatch();
+    }
+
+    Trim();
+    return uploaded;
+}
+
+void TextureCache::Insert(const std::string& path, std::shared_ptr<Texture> texture, TextureFormat viewFormat, uint64_t bytes)
+{
+    mTextures[path] = { texture, viewFormat, bytes, mFrame };
+    mStats.ResidentBytes += bytes;
+    mStats.ResidentCount++;
+}
+
+void TextureCache::Trim()
+{
+    mFrame++;
+    mStats.Budget = mBudget;
+
+    mStats.ReferencedBytes = 0;
+    for (auto& [path, cached] : mTextures) {
+        if (cached.Texture.use_count() > 1) {
+            cached.LastUse = mFrame;
+            mStats.ReferencedBytes += cached.Bytes;
+        }
+    }
+    if (mStats.ResidentBytes <= mBudget) {
+        mOverBudget = false;
+        return;
+    }
+
+    // Pending uploads hold their texture too, so only textures no material uses anymore are candidates
+    std::vector<std::unordered_map<std::string, CachedTexture>::iterator> unreferenced;
+    for (auto it = mTextures.begin(); it != mTextures.end(); ++it) {
+        if (it->second.Texture.use_count() == 1) {
+            unreferenced.push_back(it);
+        }
     }
+    std::sort(unreferenced.begin(), unreferenced.end(), [](const auto& a, const auto& b) {
+        return a->second.LastUse < b->second.LastUse;
+    });
 
-    return nullptr;
+    uint32_t evictions = 0;
+    uint64_t evictedBytes = 0;
+    for (auto& it : unreferenced) {
+        if (mStats.ResidentBytes <= mBudget) {
+            break;
+        }
+
+        evictions++;
+        evictedBytes += it->second.Bytes;
+        mStats.ResidentBytes -= it->second.Bytes;
+        mStats.ResidentCount--;
+        mReady.erase(it->second.Texture.get());
+        mTextures.erase(it);
+    }
+    mStats.Evictions += evictions;
+    mStats.EvictedBytes += evictedBytes;
+
+    if (evictions > 0) {
+        LOG_INFO("Evicted {} texture(s) ({} bytes), {} bytes resident for a budget of {}", evictions, evictedBytes, mStats.ResidentBytes, mBudget);
+    }
+    if (mStats.ResidentBytes > mBudget && !mOverBudget) {
+        LOG_WARN("Textures in use take {} bytes, over the budget of {}", mStats.ReferencedBytes, mBudget);
+    }
+    mOverBudget = mStats.ResidentBytes > mBudget;
+}
+
+void TextureCache::Wait()
+{
+    if (mPending.empty()) {
+        return;
+    }
+
+    for (auto& pending : mPending) {
+        Upload(pending);
+    }
+    mPending.clear();
+    EndBatch();
+}
+
+void TextureCache::EndBatch()
+{
+    auto end = std::chrono::high_resolution_clock::now();
+    float ms = std::chrono::duration<float, std::milli>(end - mBatchStart).count();
+    LOG_INFO("{} texture(s) ready in {:.2f}ms ({} cooked, {} processed so far)", mBatchCount, ms, mCookHits.load(), mCookMisses.load());
 }
 
 void TextureCache::Clear()
 {
+    // Nothing is uploaded anymore, the jobs only have to be done with their ImageData
+    for (auto& pending : mPending) {
+        pending.Job.wait();
+    }
+    mPending.clear();
+    mReady.clear();
     mTextures.clear();
+    mStats.ResidentBytes = 0;
+    mStats.ResidentCount = 0;
+    mStats.ReferencedBytes = 0;
 }
@@ -6,14 +6,161 @@
 #pragma once
 
 #include <Oslo/Oslo.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Util/BlockCompression.hpp"
+#include "Util/MipGenerator.hpp"
+
+/*
+    Textures are created from the image header alone and handed back right away, the JPEG/PNG decode runs on the job system.
+    Update() uploads whatever finished decoding since the last call, until then the texture has undefined contents and must not be bound:
+    materials point their shader indices at placeholders until IsReady() says the upload is queued (see GLTF::RefreshMaterials).
+    The decode job also builds the full mip chain (Util/MipGenerator.hpp), filtered the way the texture is sampled.
+    Images the header reader doesn't know are decoded synchronously like before.
+    The chain is then block compressed (Util/BlockCompression.hpp) according to what the texture holds:
+        - Albedo: BC7 (BC1 with TextureCompression::Size), viewed as sRGB.
+        - Normal: BC5, only XY are kept, the shader rebuilds Z.
+        - MetallicRoughness: glTF's G (roughness) and B (metallic) are moved to R and G, then BC5.
+        - Color: BC7 (BC1 with TextureCompression::Size).
+    Textures whose size isn't a multiple of 4 stay RGBA8.
+    Compression is only compiled in with the block_compression xmake option (PATHTRACER_BLOCK_COMPRESSION), everything is RGBA8 otherwise.
+    It needs an Oslo with the BC1/BC5/BC7 (+ _sRGB) TextureFormats whose uploader copies tightly packed block rows per level:
+    row pitch = ceil(width / 4) * BlockBytes, ceil(height / 4) rows, levels back to back (BlockCompressedSize).
+    The processed bytes are kept on disk (Cache/TextureCooker.hpp), a warm start maps them instead of decoding anything.
+    Images decoded synchronously skip that cache, their size is only known after the decode.
+
+    Residency: materials (and their views) hold the textures they sample, the cache's own reference doesn't count.
+    Textures nobody else holds stay resident for reuse until the cache goes over its budget, Update() then evicts them least recently used first.
+    Referenced textures are never touched, the budget can be exceeded by what's in use alone.
+    A texture requested again after its eviction comes back from the on-disk cache.
+*/
+
+#define TEXTURE_BUDGET_DEFAULT (1024ull << 20)
+
+struct TextureCacheStats
+{
+    uint64_t ResidentBytes;
+    uint32_t ResidentCount;
+    uint64_t ReferencedBytes;
+    uint64_t Budget;
+
+    uint32_t Evictions;
+    uint64_t EvictedBytes;
+
+    uint32_t Hits;
+    uint32_t Misses;
+
+    float HitRate() const { return Hits + Misses ? static_cast<float>(Hits) / (Hits + Misses) : 0.0f; }
+};
+
+enum class TextureKind : uint32_t
+{
+    Color,
+    Albedo,
+    Normal,
+    MetallicRoughness
+};
+
+enum class TextureCompression : uint32_t
+{
+    None,
+    Quality,
+    Size
+};
 
 class TextureCache
 {
 public:
-    static std::shared_ptr<Texture> Get(const std::string& path);
+    /// @note(ame): main thread only. The kind only matters to the first request of a path.
+    /// viewFormat receives the format shader resource views of the texture must use.
+    static std::shared_ptr<Texture> Get(const std::string& path, TextureKind kind = TextureKind::Color, TextureFormat* viewFormat = nullptr);
+    /// @note(ame): main thread, at a frame boundary. Enqueues the uploads of finished decodes, returns true if there were any (flush them).
+    /// Evicts unreferenced textures when over budget.
+    static bool Update();
+    /// @note(ame): waits for every decode in flight and enqueues their uploads.
+    static void Wait();
     static void Clear();
 
+    /// @note(ame): the CPU side of Get on the calling thread, nothing is created on the GPU: reads the cook, or decodes, processes and cooks the image.
+    /// data ends up with the bytes Get would upload. Thread safe, used by the texture benchmarks.
+    static void Prepare(const std::string& path, TextureKind kind, ImageData& data);
+
+    static uint32_t GetPendingCount() { return static_cast<uint32_t>(mPending.size()); }
+    /// @note(ame): true once the texture's upload is enqueued, it holds its texels after the next Uploader::Flush.
+    /// Stays false for a texture whose decode failed, it never gets any.
+    static bool IsReady(const Texture* texture) { return mReady.count(texture) > 0; }
+
+    /// @note(ame): applies to textures requested after the call. Ignored without PATHTRACER_BLOCK_COMPRESSION.
+    static void SetCompression(TextureCompression compression) { mCompression = compression; }
+    static TextureCompression GetCompression() { return mCompression; }
+    /// @note(ame): on by default. Off neither reads nor writes the on-disk cache.
+    static void SetCooking(bool enabled) { mCooking = enabled; }
+
+    static uint32_t GetCookHits() { return mCookHits; }
+    static uint32_t GetCookMisses() { return mCookMisses; }
+
+    /// @note(ame): bytes of uploaded texels (mip chains, compressed sizes). Checked on the next Update().
+    static void SetBudget(uint64_t bytes) { mBudget = bytes; }
+    static const TextureCacheStats& GetStats() { return mStats; }
+
 private:
-    static std::unordered_map<std::string, std::shared_ptr<Texture>> mTextures;
+    struct CachedTexture
+    {
+        std::shared_ptr<Texture> Texture;
+        TextureFormat ViewFormat;
+        uint64_t Bytes;
+        uint64_t LastUse;
+    };
+
+    struct Encoding
+    {
+        TextureFormat Format;
+        TextureFormat ViewFormat;
+        bool Compressed;
+        BlockFormat Block;
+    };
+
+    struct PendingTexture
+    {
+        std::string Path;
+        uint32_t Width;
+        uint32_t Height;
+        std::shared_ptr<Texture> Texture;
+        std::shared_ptr<ImageData> Data;
+        std::future<void> Job;
+    };
+
+    static Encoding ChooseEncoding(TextureKind kind, uint32_t width, uint32_t height);
+    /// @note(ame): everything besides the source image that changes the processed bytes.
+    static uint64_t SettingsKey(TextureKind kind, const Encoding& encoding);
+    static size_t ProcessedSize(const Encoding& encoding, uint32_t width, uint32_t height);
+    /// @note(ame): swizzle, mip chain and compression, data.Pixels ends up in the layout of encoding.Format.
+    static void Process(ImageData& data, TextureKind kind, const Encoding& encoding);
+    /// @note(ame): body of the Get jobs, the image is expected at width x height.
+    static void Decode(const std::string& path, TextureKind kind, const Encoding& encoding, uint32_t width, uint32_t height, bool cooking, ImageData& data);
+    static void Upload(PendingTexture& pending);
+    /// @note(ame): logs how long it took to go through the textures requested since mPending was last empty.
+    static void EndBatch();
+    static void Insert(const std::string& path, std::shared_ptr<Texture> texture, TextureFormat viewFormat, uint64_t bytes);
+    /// @note(ame): refreshes LastUse of referenced textures and evicts the others down to the budget.
+    static void Trim();
+
+    static std::unordered_map<std::string, CachedTexture> mTextures;
+    static std::vector<PendingTexture> mPending;
+    static std::unordered_set<const Texture*> mReady;
+    static TextureCompression mCompression;
+    static bool mCooking;
+    static std::atomic<uint32_t> mCookHits;
+    static std::atomic<uint32_t> mCookMisses;
+    static std::chrono::high_resolution_clock::time_point mBatchStart;
+    static uint32_t mBatchCount;
+    static uint64_t mBudget;
+    static uint64_t mFrame;
+    static bool mOverBudget;
+    static TextureCacheStats mStats;
 };
@@ -0,0 +1,157 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-25 09:58:40
+//
+
+#include "TextureCooker.hpp"
+#include "Util/Hash.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+static constexpr uint32_t COOK_MAGIC = 0x4B435450; // 'PTCK'
+static constexpr uint64_t COOK_ALIGNMENT = 16;
+
+struct TextureCookHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t SourceHash;
+    uint64_t SettingsKey;
+
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t Levels;
+    uint32_t Pad;
+
+    uint64_t PixelsOffset;
+    uint64_t PixelsSize;
+    uint64_t FileSize;
+};
+
+const std::string& TextureCooker::GetDirectory()
+{
+    static std::string directory = std::string(TEXTURE_COOK_DIRECTORY) + "/v" + std::to_string(TEXTURE_COOK_VERSION);
+    static std::once_flag once;
+
+    std::call_once(once, []() {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            LOG_WARN("Failed to create {}: {}", directory, error.message());
+            return;
+        }
+
+        // Entries of other versions can never be read again
+        std::string current = "v" + std::to_string(TEXTURE_COOK_VERSION);
+        for (auto& entry : std::filesystem::directory_iterator(TEXTURE_COOK_DIRECTORY, error)) {
+            std::string name = entry.path().filename().string();
+            if (entry.is_directory(error) && name.size() > 1 && name[0] == 'v' && name != current) {
+                LOG_INFO("Removing texture cache {}", entry.path().string());
+                std::filesystem::remove_all(entry.path(), error);
+            }
+        }
+    });
+    return directory;
+}
+
+std::string TextureCooker::GetCookPath(uint64_t sourceHash, uint64_t settingsKey)
+{
+    char name[40];
+    snprintf(name, sizeof(name), "%016llx-%016llx.tex", static_cast<unsigned long long>(sourceHash), static_cast<unsigned long long>(settingsKey));
+    return GetDirectory() + '/' + name;
+}
+
+bool TextureCooker::HashSource(const std::string& path, uint64_t& hash)
+{
+    MappedFile source;
+    if (!source.Open(path)) {
+        return false;
+    }
+    hash = Hash64(source.Data(), source.Size(), TEXTURE_COOK_VERSION);
+    return true;
+}
+
+bool TextureCooker::Read(uint64_t sourceHash, uint64_t settingsKey, TextureCook& out)
+{
+    std::string path = GetCookPath(sourceHash, settingsKey);
+
+    MappedFile& file = out.File;
+    if (!file.Open(path)) {
+        return false;
+    }
+
+    const TextureCookHeader* header = file.Size() >= sizeof(TextureCookHeader) ? reinterpret_cast<const TextureCookHeader*>(file.Data()) : nullptr;
+    if (!header || header->Magic != COOK_MAGIC || header->Version != TEXTURE_COOK_VERSION || header->FileSize != file.Size()) {
+        LOG_WARN("Texture cook {} is invalid or truncated, rebuilding", path);
+        file.Close();
+        return false;
+    }
+    // Only a hash collision on the file name gets here
+    if (header->SourceHash != sourceHash || header->SettingsKey != settingsKey) {
+        LOG_WARN("Texture cook {} belongs to another texture, rebuilding", path);
+        file.Close();
+        return false;
+    }
+    if (header->PixelsOffset > file.Size() || header->PixelsSize > file.Size() - header->PixelsOffset) {
+        LOG_WARN("Texture cook {} is truncated, rebuilding", path);
+        file.Close();
+        return false;
+    }
+
+    out.Width = header->Width;
+    out.Height = header->Height;
+    out.Levels = header->Levels;
+    out.Pixels = file.Data() + header->PixelsOffset;
+    out.Size = header->PixelsSize;
+    return true;
+}
+
+void TextureCooker::Write(uint64_t sourceHash, uint64_t settingsKey, uint32_t width, uint32_t height, uint32_t levels, const std::vector<uint8_t>& pixels)
+{
+    TextureCookHeader header = {};
+    header.Magic = COOK_MAGIC;
+    header.Version = TEXTURE_COOK_VERSION;
+    header.SourceHash = sourceHash;
+    header.SettingsKey = settingsKey;
+    header.Width = width;
+    header.Height = height;
+    header.Levels = levels;
+    header.PixelsOffset = (sizeof(TextureCookHeader) + COOK_ALIGNMENT - 1) & ~(COOK_ALIGNMENT - 1);
+    header.PixelsSize = pixels.size();
+    header.FileSize = header.PixelsOffset + header.PixelsSize;
+
+    // Two paths with the same contents write the same entry from different jobs, the temporary has to be per thread
+    std::string cookPath = GetCookPath(sourceHash, settingsKey);
+    std::string tempPath = cookPath + '.' + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            LOG_WARN("Failed to open {} for writing", tempPath);
+            return;
+        }
+
+        static const char zeroes[COOK_ALIGNMENT] = {};
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(zeroes, header.PixelsOffset - sizeof(header));
+        stream.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+
+        if (!stream.good()) {
+            LOG_WARN("Failed to write {}", tempPath);
+            stream.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cookPath, error);
+    if (error) {
+        LOG_WARN("Failed to move {} to {}: {}", tempPath, cookPath, error.message());
+        std::filesystem::remove(tempPath, error);
+    }
+}
@@ -0,0 +1,47 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-25 09:41:12
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "Util/MappedFile.hpp"
+
+/*
+    On-disk cache of processed textures (decoded, swizzled, mipped and block compressed), the upload-ready bytes of TextureCache.
+    Entries live in TEXTURE_COOK_DIRECTORY/v<TEXTURE_COOK_VERSION>/ and are named after the hash of the source image and a settings key.
+    An edited image hashes differently and misses, a changed setting (kind, format, compression) too, the old entry is simply never read again.
+    Directories of other versions are deleted the first time the cache is touched.
+    Bump TEXTURE_COOK_VERSION whenever anything that feeds the bytes (Util/MipGenerator, Util/BlockCompression, swizzles) changes.
+*/
+
+#define TEXTURE_COOK_VERSION 1
+#define TEXTURE_COOK_DIRECTORY ".cache/textures"
+
+/// @note(ame): Pixels points into File.
+struct TextureCook
+{
+    MappedFile File;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t Levels;
+    const uint8_t* Pixels;
+    uint64_t Size;
+};
+
+class TextureCooker
+{
+public:
+    /// @note(ame): XXH64 of the whole mapped file.
+    static bool HashSource(const std::string& path, uint64_t& hash);
+
+    /// @note(ame): false on a miss, or if the entry is invalid/truncated. Safe to call from jobs.
+    static bool Read(uint64_t sourceHash, uint64_t settingsKey, TextureCook& out);
+    static void Write(uint64_t sourceHash, uint64_t settingsKey, uint32_t width, uint32_t height, uint32_t levels, const std::vector<uint8_t>& pixels);
+
+    static std::string GetCookPath(uint64_t sourceHash, uint64_t settingsKey);
+private:
+    static const std::string& GetDirectory();
+};
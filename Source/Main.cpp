@@ -4,15 +4,18 @@
 //
 
 #include "Application.hpp"
+#include "Util/JobSystem.hpp"
 
 int main(void)
 {
     Oslo::Init();
+    JobSystem::Init();
    
     {
         Application app;
         app.Run();
     }
 
+    JobSystem::Exit();
     Oslo::Exit();
 }
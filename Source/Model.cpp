@@ -5,7 +5,16 @@
 
 #include "Model.hpp"
 #include "Cache/TextureCache.hpp"
+#include "Cache/ModelCooker.hpp"
 #include "Renderer/RendererTools.hpp"
+#include "Util/JobSystem.hpp"
+#include "Util/AccessorDecoder.hpp"
+#include "Util/VertexQuantization.hpp"
+#include "Util/Hash.hpp"
+#include "Util/TangentSpace.hpp"
+#include "Util/MeshoptDecoder.hpp"
+#include "Util/MappedFile.hpp"
+#include "Util/LinearArena.hpp"
 
 #include <Oslo/Core/Assert.hpp>
 #include <Oslo/RHI/Uploader.hpp>
@@ -14,136 +23,448 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-void ComputeTangentSpace(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
-{
-    std::vector<glm::vec3> accumulatedTangents(vertices.size(), {0, 0, 0});
-    std::vector<glm::vec3> accumulatedBitangents(vertices.size(), {0, 0, 0});
-
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        uint32_t i0 = indices[i];
-        uint32_t i1 = indices[i + 1];
-        uint32_t i2 = indices[i + 2];
+#include <cfloat>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 
-        const Vertex& v0 = vertices[i0];
-        const Vertex& v1 = vertices[i1];
-        const Vertex& v2 = vertices[i2];
+uint64_t GLTFLoadOptions::CookKey() const
+{
+    uint64_t key = Hash64(&Reorder, sizeof(Reorder));
+    if (Weld) {
+        key = HashCombine(key, Hash64(&WeldTolerance, sizeof(WeldTolerance), 1));
+    }
+    if (BuildLODs) {
+        key = HashCombine(key, Hash64(&LODSettings, sizeof(LODSettings), 2));
+    }
+    if (Tangents != TangentMode::Accumulated) {
+        key = HashCombine(key, Hash64(&Tangents, sizeof(Tangents), 3));
+    }
+    return key;
+}
 
-        glm::vec3 p0 = v0.Position;
-        glm::vec3 p1 = v1.Position;
-        glm::vec3 p2 = v2.Position;
+GLTFPreparedModel::GLTFPreparedModel() = default;
+GLTFPreparedModel::~GLTFPreparedModel() = default;
 
-        glm::vec2 uv0 = v0.UV;
-        glm::vec2 uv1 = v1.UV;
-        glm::vec2 uv2 = v2.UV;
+const GLTFSceneDesc& GLTFPreparedModel::GetScene() const
+{
+    return Cooked ? Cook->Scene : Parsed;
+}
 
-        glm::vec3 edge1 = p1 - p0;
-        glm::vec3 edge2 = p2 - p0;
+void GLTFPreparedModel::Release()
+{
+    Cook.reset();
+    Parsed = {};
+    Storage = {};
+}
 
-        float u1 = uv1.x - uv0.x;
-        float v1_ = uv1.y - uv0.y;
-        float u2 = uv2.x - uv0.x;
-        float v2_ = uv2.y - uv0.y;
+void GLTF::Load(const std::string& path, const GLTFLoadOptions& loadOptions)
+{
+    GLTFPreparedModel prepared;
+    Prepare(path, loadOptions, prepared);
+    Finish(prepared);
+}
 
-        float det = (u1 * v2_ - u2 * v1_);
-        float invDet = (det != 0.0f) ? 1.0f / det : 0.0f;
+void GLTF::Prepare(const std::string& path, const GLTFLoadOptions& loadOptions, GLTFPreparedModel& out, GLTFLoadProgress* progress)
+{
+    auto start = std::chrono::high_resolution_clock::now();
 
-        glm::vec3 tangent = (edge1 * v2_ - edge2 * v1_) * invDet;
-        glm::vec3 bitangent = (edge2 * u1 - edge1 * u2) * invDet;
+    out.Path = path;
+    out.Options = loadOptions;
 
-        // Accumulate tangents and bitangents
-        accumulatedTangents[i0] += tangent;
-        accumulatedTangents[i1] += tangent;
-        accumulatedTangents[i2] += tangent;
+    // Warm start: everything comes straight out of the mapped cook
+    out.Cook = std::make_unique<ModelCook>();
+    out.Cooked = loadOptions.UseCook && ModelCooker::Read(path, loadOptions, *out.Cook);
+    if (!out.Cooked) {
+        out.Cook.reset();
+        Parse(path, loadOptions, out.Parsed, out.Storage, progress);
 
-        accumulatedBitangents[i0] += bitangent;
-        accumulatedBitangents[i1] += bitangent;
-        accumulatedBitangents[i2] += bitangent;
+        // The cook only needs the CPU side, no reason to wait for the commit
+        if (loadOptions.UseCook) {
+            ModelCooker::Write(path, loadOptions, out.Parsed);
+        }
+    } else if (progress) {
+        progress->PrimitiveCount = static_cast<uint32_t>(out.Cook->Scene.Primitives.size());
+        progress->PrimitivesDecoded = static_cast<uint32_t>(out.Cook->Scene.Primitives.size());
     }
 
-    // Normalize and orthogonalize
-    for (size_t i = 0; i < vertices.size(); ++i) {
-        glm::vec3 n = vertices[i].Normal;
-        glm::vec3 t = accumulatedTangents[i];
+    auto end = std::chrono::high_resolution_clock::now();
+    out.PrepareMs = std::chrono::duration<float, std::milli>(end - start).count();
+}
 
-        // Gram-Schmidt orthogonalization
-        t = glm::normalize(t - glm::dot(n, t) * n);
+void GLTF::Finish(GLTFPreparedModel& prepared)
+{
+    auto start = std::chrono::high_resolution_clock::now();
 
-        // Compute handedness via bitangent
-        glm::vec3 b = glm::cross(n, t);
-        glm::vec3 expectedB = accumulatedBitangents[i];
+    const std::string& path = prepared.Path;
+    const GLTFLoadOptions& loadOptions = prepared.Options;
 
-        // If the bitangent is pointing in the wrong direction, flip the tangent
-        float handedness = (glm::dot(b, expectedB) < 0.0f) ? -1.0f : 1.0f;
+    Path = path;
+    Directory = path.substr(0, path.find_last_of('/'));
+    Commit(prepared.GetScene(), loadOptions);
 
-        // Store the tangent and bitangent (bitangent only if you need it separately)
-        vertices[i].Tangent = t * handedness;
-        vertices[i].Bitangent = glm::cross(n, t) * handedness; // Optional, for use in shaders
+    auto end = std::chrono::high_resolution_clock::now();
+    float ms = std::chrono::duration<float, std::milli>(end - start).count();
+    LOG_INFO("Loaded {} ({} vertices, {} indices) in {:.2f}ms + {:.2f}ms commit ({}, {})", path, VertexCount, IndexCount, prepared.PrepareMs, ms, prepared.Cooked ? "cooked" : "parsed", loadOptions.Parallel ? "parallel" : "serial");
+    if (loadOptions.BuildClusters) {
+        LOG_INFO("{}: {} clusters ({:.1f} triangles per cluster)", path, ClusterCount, ClusterCount ? IndexCount / 3.0f / ClusterCount : 0.0f);
+    }
+    if (SharedMeshInstances > 0) {
+        LOG_INFO("{}: {} mesh instances share geometry, saved {:.2f}MB of vertex/index data and their BLASes", path, SharedMeshInstances, SharedGeometryBytesSaved / (1024.0f * 1024.0f));
+    }
+    if (MaterialReferences > 0) {
+        LOG_INFO("{}: {} materials for {} primitives, {} -> {} texture views, material buffer {} -> {} bytes", path, Materials.size(), MaterialReferences, MaterialViewReferences, MaterialViewCount, MaterialReferences * sizeof(RaytracingMaterial), Materials.size() * sizeof(RaytracingMaterial));
     }
 }
 
-void GLTF::Load(const std::string& path)
+/// @note(ame): points every external buffer at a read-only mapping of its file instead of a heap copy.
+/// Whatever is left (GLB binary chunk, data: URIs, missing files) goes through cgltf_load_buffers as usual.
+static void MapBuffers(const std::string& path, cgltf_data* data, std::vector<std::unique_ptr<MappedFile>>& mappings)
 {
-    Path = path;
-    Directory = path.substr(0, path.find_last_of('/'));
+    std::string directory = path.substr(0, path.find_last_of('/') + 1);
+    for (size_t i = 0; i < data->buffers_count; i++) {
+        cgltf_buffer& buffer = data->buffers[i];
+        if (buffer.data || !buffer.uri || strncmp(buffer.uri, "data:", 5) == 0 || strstr(buffer.uri, "://")) {
+            continue;
+        }
+
+        std::string uri = buffer.uri;
+        uri.resize(cgltf_decode_uri(uri.data()));
+
+        auto mapping = std::make_unique<MappedFile>();
+        if (!mapping->Open(directory + uri) || mapping->Size() < buffer.size) {
+            continue;
+        }
+        buffer.data = const_cast<uint8_t*>(mapping->Data());
+        buffer.data_free_method = cgltf_data_free_method_none;
+        mappings.push_back(std::move(mapping));
+    }
+}
 
+void GLTF::Parse(const std::string& path, const GLTFLoadOptions& loadOptions, GLTFSceneDesc& desc, std::vector<GLTFPrimitiveData>& storage, GLTFLoadProgress* progress)
+{
     cgltf_options options = {};
     cgltf_data* data = nullptr;
 
-    ASSERT(cgltf_parse_file(&options, path.c_str(), &data) == cgltf_result_success, "Failed to parse GLTF file!");
+    // The .gltf/.glb itself and the external buffers are mapped: accessors decode straight from the page cache,
+    // and a GLB's binary chunk is used in place (cgltf_parse keeps data->bin pointing into the mapping)
+    std::vector<std::unique_ptr<MappedFile>> mappings;
+    mappings.push_back(std::make_unique<MappedFile>());
+    ASSERT(mappings[0]->Open(path), "Failed to open GLTF file!");
+    ASSERT(cgltf_parse(&options, mappings[0]->Data(), mappings[0]->Size(), &data) == cgltf_result_success, "Failed to parse GLTF file!");
+    MapBuffers(path, data, mappings);
     ASSERT(cgltf_load_buffers(&options, data, path.c_str()) == cgltf_result_success, "Failed to load GLTF buffers!");
     cgltf_scene *scene = data->scene;
 
-    Root = new GLTFNode;
-    Root->Name = "RootNode";
-    Root->Parent = nullptr;
-    Root->Transform = glm::mat4(1.0f);
-    Root->Children.resize(scene->nodes_count);
+    // EXT_meshopt_compression views are decoded up front, accessors then read them like any other view
+    uint32_t compressedViews = MeshoptDecoder::DecompressBufferViews(data, loadOptions.Parallel);
+    if (compressedViews > 0) {
+        LOG_INFO("{}: decoded {} meshopt compressed buffer views", path, compressedViews);
+    }
 
-    for (int i = 0; i < scene->nodes_count; i++) {
-        Root->Children[i] = new GLTFNode;
-        Root->Children[i]->Parent = Root;
-        Root->Children[i]->Transform = glm::mat4(1.0f);
+    for (int i = 0; i < data->buffers_count; i++) {
+        const char* uri = data->buffers[i].uri;
+        if (uri && strncmp(uri, "data:", 5) != 0) {
+            std::string dependency = uri;
+            dependency.resize(cgltf_decode_uri(dependency.data()));
+            desc.Dependencies.push_back(dependency);
+        }
+    }
 
-        ProcessNode(scene->nodes[i], Root->Children[i]);
+    // Walk the hierarchy first: it's cheap, and every mesh is only queued by the first node that references it
+    ParseState state;
+    state.Path = path;
+    state.Data = data;
+    for (int i = 0; i < scene->nodes_count; i++) {
+        ProcessNode(scene->nodes[i], -1, desc, state);
     }
 
-    // Create material buffer
-    std::vector<RaytracingMaterial> rtMaterials;
-    for (auto& material : Materials) {
-        RaytracingMaterial mat = {};
-        mat.AlbedoIndex = material.AlbedoView->GetDescriptor().Index;
-        mat.NormalIndex = material.NormalView ? material.NormalView->GetDescriptor().Index : -1;
-        mat.PBRIndex = material.PBRView ? material.PBRView->GetDescriptor().Index : -1;
+    // CPU work (decode, tangents) fans out, GPU resources are committed in file order afterwards
+    storage.resize(state.Primitives.size());
+    if (progress) {
+        progress->PrimitiveCount = static_cast<uint32_t>(storage.size());
+    }
+    ArenaStats arenaBefore = LinearArena::GetStats();
+    auto decode = [&](uint32_t i) {
+        // Every temporary of the decode comes out of the worker's arena and is gone once the primitive is done
+        ArenaScope scope;
+        DecodePrimitive(state.Primitives[i], loadOptions, storage[i]);
+        if (progress) {
+            progress->PrimitivesDecoded++;
+        }
+    };
+    if (loadOptions.Parallel) {
+        JobSystem::ParallelFor(static_cast<uint32_t>(storage.size()), decode);
+    } else {
+        for (uint32_t i = 0; i < storage.size(); i++) {
+            decode(i);
+        }
+    }
 
-        rtMaterials.push_back(mat);
+    // Primitives own copies of everything they need now, give the address space back before post-processing and the cook write
+    uint64_t mappedBytes = 0;
+    for (auto& mapping : mappings) {
+        mappedBytes += mapping->Size();
+        mapping->Close();
+    }
+    for (size_t i = 0; i < data->buffers_count; i++) {
+        if (data->buffers[i].data_free_method == cgltf_data_free_method_none) {
+            data->buffers[i].data = nullptr;
+        }
+    }
+    data->bin = nullptr;
+    LOG_INFO("{}: decoded from {} mapped files ({:.2f}MB)", path, mappings.size(), mappedBytes / (1024.0f * 1024.0f));
+
+    ArenaStats arenaAfter = LinearArena::GetStats();
+    LOG_INFO("{}: {} decode temporaries ({:.2f}MB) served by {} arena block allocations", path, arenaAfter.Allocations - arenaBefore.Allocations, (arenaAfter.BytesAllocated - arenaBefore.BytesAllocated) / (1024.0f * 1024.0f), arenaAfter.BlockAllocations - arenaBefore.BlockAllocations);
+
+    LocalityStats before;
+    LocalityStats after;
+    uint64_t weldedBefore = 0;
+    uint64_t weldedAfter = 0;
+    uint32_t lodLevels = 0;
+    for (size_t i = 0; i < storage.size(); i++) {
+        GLTFPrimitiveDesc& primitive = desc.Primitives[i];
+        if (storage[i].Valid) {
+            primitive.Vertices = storage[i].Vertices.data();
+            primitive.Indices = storage[i].Indices.data();
+            primitive.VertexCount = static_cast<uint32_t>(storage[i].Vertices.size());
+            primitive.IndexCount = static_cast<uint32_t>(storage[i].Indices.size());
+            primitive.LODIndices = storage[i].LODIndices.data();
+            primitive.LODLevels = storage[i].LODLevels.data();
+            primitive.LODIndexCount = static_cast<uint32_t>(storage[i].LODIndices.size());
+            primitive.LODCount = static_cast<uint32_t>(storage[i].LODLevels.size());
+            lodLevels += primitive.LODCount;
+
+            before.Add(storage[i].LocalityBefore);
+            after.Add(storage[i].LocalityAfter);
+
+            const WeldStats& weld = storage[i].Weld;
+            if (weld.VerticesAfter < weld.VerticesBefore) {
+                LOG_INFO("{}: primitive {} welded {} -> {} vertices (-{:.1f}%)", path, i, weld.VerticesBefore, weld.VerticesAfter, 100.0f * (weld.VerticesBefore - weld.VerticesAfter) / weld.VerticesBefore);
+            }
+            weldedBefore += weld.VerticesBefore;
+            weldedAfter += weld.VerticesAfter;
+        }
+    }
+    if (loadOptions.BuildLODs) {
+        LOG_INFO("{}: built {} LOD levels over {} primitives (CPU only, not traced)", path, lodLevels, storage.size());
+    }
+    if (loadOptions.Weld && weldedBefore > 0) {
+        LOG_INFO("{}: welding removed {} of {} vertices", path, weldedBefore - weldedAfter, weldedBefore);
     }
+    if (loadOptions.Reorder != TriangleOrder::Original) {
+        LOG_INFO("{}: {} reorder, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, index span {:.1f} -> {:.1f}", path, loadOptions.Reorder == TriangleOrder::Forsyth ? "Forsyth" : "Morton", before.ACMR(), after.ACMR(), before.ATVR(), after.ATVR(), before.AverageIndexSpan(), after.AverageIndexSpan());
+    }
+    cgltf_free(data);
+}
 
-    MaterialBuffer = std::make_shared<Buffer>(sizeof(RaytracingMaterial) * rtMaterials.size(), sizeof(RaytracingMaterial), BufferType::Storage, "Material Buffer");
-    MaterialBuffer->BuildSRV();
+/// @note(ame): textures still decoding sample as black (albedo) or aren't sampled at all (-1, normal and PBR).
+static RaytracingMaterial MaterialEntry(const GLTFMaterial& material)
+{
+    RaytracingMaterial mat = {};
+    mat.AlbedoIndex = material.AlbedoView->GetDescriptor().Index;
+    mat.NormalIndex = material.NormalView ? material.NormalView->GetDescriptor().Index : -1;
+    mat.PBRIndex = material.PBRView ? material.PBRView->GetDescriptor().Index : -1;
 
-    Uploader::EnqueueBufferUpload(rtMaterials.data(), MaterialBuffer->GetSize(), MaterialBuffer);
+    if (material.OwnsAlbedoView && !TextureCache::IsReady(material.Albedo.get())) {
+        mat.AlbedoIndex = RendererTools::Get("BlackTexture")->GetView(ViewType::ShaderResource)->GetDescriptor().Index;
+    }
+    if (material.NormalView && !TextureCache::IsReady(material.Normal.get())) {
+        mat.NormalIndex = -1;
+    }
+    if (material.PBRView && !TextureCache::IsReady(material.PBR.get())) {
+        mat.PBRIndex = -1;
+    }
+    return mat;
 }
 
-GLTF::~GLTF()
+void GLTF::Commit(const GLTFSceneDesc& desc, const GLTFLoadOptions& options)
 {
-    FreeNodes(Root);
+    // desc.Nodes is already parents first, the root goes in front and everything shifts by one
+    Nodes = {};
+    Nodes.Reserve(desc.Nodes.size() + 1);
+    Nodes.Push("RootNode", -1, glm::mat4(1.0f));
+
+    // Bookkeeping and upload staging live in the main thread's arena until the commit is done
+    ArenaStats arenaBefore = LinearArena::GetStats();
+    ArenaScope scope;
+    LinearArena& arena = scope.Arena;
+
+    int* meshOwners = arena.Allocate<int>(desc.Meshes.size(), -1);
+    for (size_t i = 0; i < desc.Nodes.size(); i++) {
+        const GLTFNodeDesc& nodeDesc = desc.Nodes[i];
+        Nodes.Push(nodeDesc.Name, nodeDesc.Parent + 1, nodeDesc.Transform);
+
+        if (nodeDesc.Mesh != -1 && meshOwners[nodeDesc.Mesh] == -1) {
+            meshOwners[nodeDesc.Mesh] = static_cast<int>(i);
+        }
+    }
+
+    // Every mesh is uploaded once. Materials are created the first time a primitive uses them and shared from then on,
+    // the last slot of materialSlots stands for primitives without a material
+    Materials.clear();
+    MaterialReferences = 0;
+    MaterialViewReferences = 0;
+    MaterialViewCount = 0;
+    int* materialSlots = arena.Allocate<int>(desc.Materials.size() + 1, -1);
+
+    std::vector<std::vector<GLTFPrimitive>> meshes(desc.Meshes.size());
+    for (size_t i = 0; i < desc.Meshes.size(); i++) {
+        const GLTFMeshDesc& mesh = desc.Meshes[i];
+        const std::string& name = meshOwners[i] != -1 ? desc.Nodes[meshOwners[i]].Name : "Unreferenced Mesh";
+
+        for (uint32_t j = 0; j < mesh.PrimitiveCount; j++) {
+            const GLTFPrimitiveDesc& primitive = desc.Primitives[mesh.FirstPrimitive + j];
+
+            GLTFPrimitive out;
+            if (!ProcessPrimitive(primitive, name, options, out)) {
+                continue;
+            }
+
+            const GLTFMaterialDesc* material = primitive.Material != -1 ? &desc.Materials[primitive.Material] : nullptr;
+            int& slot = materialSlots[primitive.Material != -1 ? primitive.Material : desc.Materials.size()];
+            if (slot == -1) {
+                slot = static_cast<int>(Materials.size());
+                Materials.push_back(ProcessMaterial(material));
+                MaterialViewCount += Materials.back().ViewCount();
+            }
+            out.MaterialIndex = slot;
+            MaterialReferences++;
+            MaterialViewReferences += Materials[slot].ViewCount();
+
+            meshes[i].push_back(out);
+        }
+    }
+
+    // Place every reference, instances only differ by their transform
+    Primitives.clear();
+    uint32_t* referenceCounts = arena.Allocate<uint32_t>(desc.Meshes.size(), 0);
+    for (size_t i = 0; i < desc.Nodes.size(); i++) {
+        int mesh = desc.Nodes[i].Mesh;
+        uint32_t node = static_cast<uint32_t>(i + 1);
+        Nodes.FirstPrimitive[node] = static_cast<uint32_t>(Primitives.size());
+        if (mesh == -1) {
+            continue;
+        }
+
+        Primitives.insert(Primitives.end(), meshes[mesh].begin(), meshes[mesh].end());
+        Nodes.PrimitiveCount[node] = static_cast<uint32_t>(meshes[mesh].size());
+
+        if (referenceCounts[mesh]++ > 0) {
+            SharedMeshInstances++;
+            for (auto& primitive : meshes[mesh]) {
+                SharedGeometryBytesSaved += primitive.PositionBuffer->GetSize() + primitive.AttributeBuffer->GetSize() + primitive.IndexBuffer->GetSize();
+            }
+        }
+    }
+    UpdateWorldTransforms();
+
+    // Create material buffer
+    MaterialEntries.resize(Materials.size());
+    for (size_t i = 0; i < Materials.size(); i++) {
+        MaterialEntries[i] = MaterialEntry(Materials[i]);
+    }
+
+    MaterialBuffer = std::make_shared<Buffer>(sizeof(RaytracingMaterial) * Materials.size(), sizeof(RaytracingMaterial), BufferType::Storage, "Material Buffer");
+    MaterialBuffer->BuildSRV();
+
+    Uploader::EnqueueBufferUpload(MaterialEntries.data(), MaterialBuffer->GetSize(), MaterialBuffer);
+
+    ArenaStats arenaAfter = LinearArena::GetStats();
+    LOG_INFO("{}: {} commit temporaries ({:.2f}MB) served by {} arena block allocations", Path, arenaAfter.Allocations - arenaBefore.Allocations, (arenaAfter.BytesAllocated - arenaBefore.BytesAllocated) / (1024.0f * 1024.0f), arenaAfter.BlockAllocations - arenaBefore.BlockAllocations);
 }
 
-void GLTF::FreeNodes(GLTFNode* node)
+bool GLTF::RefreshMaterials()
 {
-    if (!node)
-        return;
+    if (!MaterialBuffer) {
+        return false;
+    }
 
-    for (GLTFNode* child : node->Children) {
-        FreeNodes(child);
+    bool changed = false;
+    for (size_t i = 0; i < Materials.size(); i++) {
+        RaytracingMaterial mat = MaterialEntry(Materials[i]);
+        if (memcmp(&mat, &MaterialEntries[i], sizeof(mat)) != 0) {
+            MaterialEntries[i] = mat;
+            changed = true;
+        }
     }
-    node->Children.clear();
 
-    delete node;
+    if (changed) {
+        MaterialBuffer = std::make_shared<Buffer>(sizeof(RaytracingMaterial) * Materials.size(), sizeof(RaytracingMaterial), BufferType::Storage, "Material Buffer");
+        MaterialBuffer->BuildSRV();
+
+        Uploader::EnqueueBufferUpload(MaterialEntries.data(), MaterialBuffer->GetSize(), MaterialBuffer);
+    }
+    return changed;
 }
 
+void GLTFHierarchy::Reserve(size_t count)
+{
+    Names.reserve(count);
+    Parents.reserve(count);
+    LocalTransforms.reserve(count);
+    WorldTransforms.reserve(count);
+    BoundsMin.reserve(count);
+    BoundsMax.reserve(count);
+    FirstPrimitive.reserve(count);
+    PrimitiveCount.reserve(count);
+}
+
+uint32_t GLTFHierarchy::Push(const std::string& name, int parent, const glm::mat4& localTransform)
+{
+    ASSERT(parent < static_cast<int>(Size()), "Hierarchy nodes must be pushed after their parent!");
+
+    Names.push_back(name);
+    Parents.push_back(parent);
+    LocalTransforms.push_back(localTransform);
+    WorldTransforms.push_back(localTransform);
+    BoundsMin.push_back(glm::vec3(FLT_MAX));
+    BoundsMax.push_back(glm::vec3(-FLT_MAX));
+    FirstPrimitive.push_back(0);
+    PrimitiveCount.push_back(0);
+    return Size() - 1;
+}
+
+void GLTF::UpdateWorldTransforms()
+{
+    BoundsMin = glm::vec3(FLT_MAX);
+    BoundsMax = glm::vec3(-FLT_MAX);
+
+    // Parents come first, so their world transform is always final by the time a child reads it
+    for (uint32_t node = 0; node < Nodes.Size(); node++) {
+        int parent = Nodes.Parents[node];
+        const glm::mat4& world = Nodes.WorldTransforms[node] = parent == -1 ? Nodes.LocalTransforms[node] : Nodes.WorldTransforms[parent] * Nodes.LocalTransforms[node];
+
+        glm::vec3 nodeMin(FLT_MAX);
+        glm::vec3 nodeMax(-FLT_MAX);
+        GLTFPrimitive* primitives = Primitives.data() + Nodes.FirstPrimitive[node];
+        for (uint32_t i = 0; i < Nodes.PrimitiveCount[node]; i++) {
+            GLTFPrimitive& primitive = primitives[i];
+            primitive.Instance.Transform = glm::mat3x4(glm::transpose(world));
+
+            // Arvo: each axis of the box contributes its min/max along each world axis
+            glm::vec3 center = glm::vec3(world[3]);
+            glm::vec3 boxMin = center;
+            glm::vec3 boxMax = center;
+            for (int axis = 0; axis < 3; axis++) {
+                glm::vec3 a = glm::vec3(world[axis]) * primitive.BoundsMin[axis];
+                glm::vec3 b = glm::vec3(world[axis]) * primitive.BoundsMax[axis];
+                boxMin += glm::min(a, b);
+                boxMax += glm::max(a, b);
+            }
+            nodeMin = glm::min(nodeMin, boxMin);
+            nodeMax = glm::max(nodeMax, boxMax);
+        }
+
+        Nodes.BoundsMin[node] = nodeMin;
+        Nodes.BoundsMax[node] = nodeMax;
+        BoundsMin = glm::min(BoundsMin, nodeMin);
+        BoundsMax = glm::max(BoundsMax, nodeMax);
+    }
+}
 
-void GLTF::ProcessNode(cgltf_node *node, GLTFNode *mnode)
+void GLTF::ProcessNode(cgltf_node *node, int parent, GLTFSceneDesc& desc, ParseState& state)
 {
     glm::mat4 localTransform(1.0f);
     glm::mat4 translationMatrix(1.0f);
@@ -168,32 +489,130 @@ void GLTF::ProcessNode(cgltf_node *node, GLTFNode *mnode)
         localTransform *= translationMatrix * rotationMatrix * scaleMatrix;
     }
 
-    mnode->Name = node->name ? node->name : "Unnamed Node " + std::to_string(rand());
-    mnode->Transform = localTransform;
+    int index = static_cast<int>(desc.Nodes.size());
+
+    GLTFNodeDesc& mnode = desc.Nodes.emplace_back();
+    mnode.Name = node->name ? node->name : "Unnamed Node " + std::to_string(rand());
+    mnode.Parent = parent;
+    mnode.Transform = localTransform;
 
     if (node->mesh) {
-        for (int i = 0; i < node->mesh->primitives_count; i++) {
-            ProcessPrimitive(&node->mesh->primitives[i], mnode);
+        auto it = state.Meshes.find(node->mesh);
+        if (it == state.Meshes.end()) {
+            GLTFMeshDesc mesh;
+            mesh.FirstPrimitive = static_cast<uint32_t>(desc.Primitives.size());
+            mesh.PrimitiveCount = static_cast<uint32_t>(node->mesh->primitives_count);
+
+            for (int i = 0; i < node->mesh->primitives_count; i++) {
+                cgltf_primitive* primitive = &node->mesh->primitives[i];
+
+                GLTFPrimitiveDesc primitiveDesc;
+                primitiveDesc.Material = ProcessMaterial(primitive->material, desc, state);
+                desc.Primitives.push_back(primitiveDesc);
+                state.Primitives.push_back(primitive);
+            }
+
+            it = state.Meshes.emplace(node->mesh, static_cast<int>(desc.Meshes.size())).first;
+            desc.Meshes.push_back(mesh);
         }
+        desc.Nodes[index].Mesh = it->second;
     }
 
-    mnode->Children.resize(node->children_count);
     for (int i = 0; i < node->children_count; i++) {
-        mnode->Children[i] = new GLTFNode;
-        mnode->Children[i]->Parent = mnode;
+        ProcessNode(node->children[i], index, desc, state);
+    }
+}
 
-        ProcessNode(node->children[i], mnode->Children[i]);
+std::string GLTF::ExtractImage(cgltf_image* image, GLTFSceneDesc& desc, ParseState& state)
+{
+    auto it = state.Images.find(image);
+    if (it != state.Images.end()) {
+        return it->second;
     }
+
+    size_t index = static_cast<size_t>(image - state.Data->images);
+    const uint8_t* bytes = cgltf_buffer_view_data(image->buffer_view);
+    size_t size = image->buffer_view->size;
+    if (!bytes) {
+        LOG_WARN("{}: embedded image {} has no data", state.Path, index);
+        return state.Images[image] = "";
+    }
+
+    const char* extension = ".bin";
+    if (image->mime_type && !strcmp(image->mime_type, "image/png")) {
+        extension = ".png";
+    } else if (image->mime_type && !strcmp(image->mime_type, "image/jpeg")) {
+        extension = ".jpg";
+    }
+
+    // <model>.images/<n>.<ext>, relative to the model's directory like any other image URI
+    std::string fileName = state.Path.substr(state.Path.find_last_of('/') + 1);
+    std::string relative = fileName + ".images/" + std::to_string(index) + extension;
+    std::string directory = state.Path.substr(0, state.Path.find_last_of('/') + 1);
+    std::filesystem::path output = directory + relative;
+
+    // Only rewritten when missing or different, an edited file with the same size would otherwise survive the rebuild
+    bool upToDate = false;
+    {
+        MappedFile existing;
+        upToDate = existing.Open(output.string()) && existing.Size() == size && !memcmp(existing.Data(), bytes, size);
+    }
+    if (!upToDate) {
+        std::error_code error;
+        std::filesystem::create_directories(output.parent_path(), error);
+        std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(bytes), size);
+        if (!stream) {
+            LOG_WARN("Failed to extract embedded image to {}", output.string());
+        }
+    }
+
+    desc.Dependencies.push_back(relative);
+    return state.Images[image] = relative;
 }
 
-void GLTF::ProcessPrimitive(cgltf_primitive *primitive, GLTFNode *node)
+int GLTF::ProcessMaterial(cgltf_material *material, GLTFSceneDesc& desc, ParseState& state)
+{
+    if (!material) {
+        return -1;
+    }
+
+    auto it = state.Materials.find(material);
+    if (it != state.Materials.end()) {
+        return it->second;
+    }
+
+    auto imageURI = [&](const cgltf_texture_view& view) -> std::string {
+        if (!view.texture || !view.texture->image) {
+            return "";
+        }
+        if (view.texture->image->buffer_view) {
+            return ExtractImage(view.texture->image, desc, state);
+        }
+        if (!view.texture->image->uri) {
+            return "";
+        }
+        return view.texture->image->uri;
+    };
+
+    GLTFMaterialDesc materialDesc;
+    materialDesc.Albedo = imageURI(material->pbr_metallic_roughness.base_color_texture);
+    materialDesc.Normal = imageURI(material->normal_texture);
+    materialDesc.PBR = imageURI(material->pbr_metallic_roughness.metallic_roughness_texture);
+    materialDesc.AlphaTested = (material->alpha_mode != cgltf_alpha_mode_opaque);
+
+    int index = static_cast<int>(desc.Materials.size());
+    desc.Materials.push_back(materialDesc);
+    state.Materials[material] = index;
+    return index;
+}
+
+void GLTF::DecodePrimitive(cgltf_primitive *primitive, const GLTFLoadOptions& options, GLTFPrimitiveData& out)
 {
     if (primitive->type != cgltf_primitive_type_triangles) {
         return;
     }
 
-    GLTFPrimitive out;
-
     cgltf_attribute* posAttribute = nullptr;
     cgltf_attribute* uvAttribute = nullptr;
     cgltf_attribute* normAttribute = nullptr;
@@ -210,114 +629,185 @@ void GLTF::ProcessPrimitive(cgltf_primitive *primitive, GLTFNode *node)
         }
     }
 
-    int vertexCount = posAttribute->data->count;
-    int indexCount = primitive->indices->count;
+    if (!posAttribute || posAttribute->data->count == 0) {
+        return;
+    }
 
-    std::vector<Vertex> vertices = {};
-    std::vector<uint32_t> indices = {};
+    size_t vertexCount = posAttribute->data->count;
+    size_t indexCount = primitive->indices ? primitive->indices->count : vertexCount;
 
-    for (int i = 0; i < vertexCount; i++) {
-        Vertex vertex = {};
+    std::vector<Vertex>& vertices = out.Vertices;
+    std::vector<uint32_t>& indices = out.Indices;
 
-        if (!cgltf_accessor_read_float(posAttribute->data, i, glm::value_ptr(vertex.Position), 4)) {
-            vertex.Position = glm::vec3(0.0f);
-        }
-        if (uvAttribute) {
-            if (!cgltf_accessor_read_float(uvAttribute->data, i, glm::value_ptr(vertex.UV), 4)) {
-                vertex.UV = glm::vec2(0.0f);
-            }
-        } else {
-            vertex.UV = glm::vec2(0.0f);
+    vertices.resize(vertexCount, Vertex{});
+    indices.resize(indexCount);
+
+    // Attributes are required to match POSITION, a malformed file only gets the overlap decoded
+    for (const cgltf_attribute* attribute : { uvAttribute, normAttribute }) {
+        if (attribute && attribute->data->count != vertexCount) {
+            LOG_WARN("{} has {} elements for {} positions", attribute->name, attribute->data->count, vertexCount);
         }
-        if (!cgltf_accessor_read_float(normAttribute->data, i, glm::value_ptr(vertex.Normal), 4)) {
+    }
+
+    AccessorDecoder::DecodeFloats(posAttribute->data, glm::value_ptr(vertices[0].Position), vertexCount, sizeof(Vertex), 3);
+    if (uvAttribute) {
+        AccessorDecoder::DecodeFloats(uvAttribute->data, glm::value_ptr(vertices[0].UV), vertexCount, sizeof(Vertex), 2);
+    }
+    if (normAttribute) {
+        AccessorDecoder::DecodeFloats(normAttribute->data, glm::value_ptr(vertices[0].Normal), vertexCount, sizeof(Vertex), 3);
+    } else {
+        for (Vertex& vertex : vertices) {
             vertex.Normal = glm::vec3(0.0f, 0.0f, 1.0f);
         }
-
-        vertices.push_back(vertex);
     }
 
-    for (int i = 0; i < indexCount; i++) {
-        indices.push_back(cgltf_accessor_read_index(primitive->indices, i));
+    if (primitive->indices) {
+        AccessorDecoder::DecodeIndices(primitive->indices, indices.data());
+    } else {
+        for (size_t i = 0; i < indexCount; i++) {
+            indices[i] = static_cast<uint32_t>(i);
+        }
+    }
+    if (options.Weld) {
+        out.Weld = VertexWelder::Weld(vertices, indices, options.WeldTolerance);
+    }
+    bool tangentsDone = false;
+    if (options.Tangents == TangentMode::MikkTSpace) {
+        // One calculator per primitive, primitives decode concurrently
+        TangentCalculator calculator;
+        MeshData data = { vertices.data(), indices.data(), vertices.size(), indices.size() };
+        tangentsDone = calculator.Calculate(&data);
+    }
+    if (!tangentsDone) {
+        TangentSpace::Compute(vertices.data(), vertices.size(), indices.data(), indices.size());
     }
-    ComputeTangentSpace(vertices, indices);
-
-    out.VertexCount = vertexCount;
-    out.IndexCount = indexCount;
-
-    /// @note(ame): create buffers
-    out.VertexBuffer = std::make_shared<Buffer>(vertices.size() * sizeof(Vertex), sizeof(Vertex), BufferType::Storage, node->Name + " Vertex Buffer");
-    out.VertexBuffer->BuildSRV();
-
-    out.IndexBuffer = std::make_shared<Buffer>(indices.size() * sizeof(uint32_t), sizeof(uint32_t), BufferType::Storage, node->Name + " Index Buffer");
-    out.IndexBuffer->BuildSRV();
-
-    out.GeometryStructure = std::make_shared<BLAS>(out.VertexBuffer, out.IndexBuffer, out.VertexCount, out.IndexCount, node->Name + " BLAS");
 
-    /// @note(ame): load and create textures
-    cgltf_material *material = primitive->material;
+    if (options.Reorder != TriangleOrder::Original) {
+        out.LocalityBefore = MeshLocality::Measure(indices.data(), indices.size(), vertices.size());
+        MeshLocality::Optimize(vertices, indices, options.Reorder);
+        out.LocalityAfter = MeshLocality::Measure(indices.data(), indices.size(), vertices.size());
+    }
 
-    GLTFMaterial outMaterial = {};
-    out.MaterialIndex = Materials.size();
-    if (material) {
-        if (material->pbr_metallic_roughness.base_color_texture.texture) {
-            std::string path = Directory + '/' + std::string(material->pbr_metallic_roughness.base_color_texture.texture->image->uri);
-    
-            outMaterial.Albedo = TextureCache::Get(path);
-            outMaterial.AlbedoView = std::make_shared<View>(outMaterial.Albedo, ViewType::ShaderResource, ViewDimension::Texture, TextureFormat::RGBA8_sRGB);
-        } else {
-            outMaterial.Albedo = RendererTools::Get("BlackTexture")->Texture;
-            outMaterial.AlbedoView = RendererTools::Get("BlackTexture")->GetView(ViewType::ShaderResource);
+    if (options.BuildLODs) {
+        MeshSimplifier::BuildLODChain(vertices.data(), vertices.size(), indices.data(), indices.size(), options.LODSettings, out.LODIndices, out.LODLevels);
+        if (options.Reorder == TriangleOrder::Forsyth) {
+            for (const LODLevel& level : out.LODLevels) {
+                MeshLocality::OptimizeForsyth(out.LODIndices.data() + level.FirstIndex, level.IndexCount, vertices.size());
+            }
         }
+    }
+    out.Valid = true;
+}
 
-        if (material->normal_texture.texture) {
-            std::string path = Directory + '/' + std::string(material->normal_texture.texture->image->uri);
+/// @note(ame): "<name><suffix>" built in a per-thread scratch string, valid until the next call on the thread.
+static const std::string& ResourceName(const std::string& name, const char* suffix)
+{
+    thread_local std::string scratch;
+    scratch.assign(name);
+    scratch.append(suffix);
+    return scratch;
+}
 
-            outMaterial.Normal = TextureCache::Get(path);
-            outMaterial.NormalView = std::make_shared<View>(outMaterial.Normal, ViewType::ShaderResource, ViewDimension::Texture, TextureFormat::RGBA8);
-        }
+bool GLTF::ProcessPrimitive(const GLTFPrimitiveDesc& primitive, const std::string& name, const GLTFLoadOptions& options, GLTFPrimitive& out)
+{
+    if (primitive.VertexCount == 0 || primitive.IndexCount == 0) {
+        return false;
+    }
 
-        if (material->pbr_metallic_roughness.metallic_roughness_texture.texture) {
-            std::string path = Directory + '/' + std::string(material->pbr_metallic_roughness.metallic_roughness_texture.texture->image->uri);
+    out.VertexCount = primitive.VertexCount;
+    out.IndexCount = primitive.IndexCount;
+    ComputeBounds(primitive.Vertices, out.VertexCount, out.BoundsMin, out.BoundsMax);
 
-            outMaterial.PBR = TextureCache::Get(path);
-            outMaterial.PBRView = std::make_shared<View>(outMaterial.PBR, ViewType::ShaderResource, ViewDimension::Texture, TextureFormat::RGBA8);
+    /// @note(ame): create buffers
+    out.IndexBuffer = std::make_shared<Buffer>(out.IndexCount * sizeof(uint32_t), sizeof(uint32_t), BufferType::Storage, ResourceName(name, " Index Buffer"));
+    out.IndexBuffer->BuildSRV();
+    Uploader::EnqueueBufferUpload(primitive.Indices, out.IndexBuffer->GetSize(), out.IndexBuffer);
+
+    // Staging for the uploads, the uploader copies them at enqueue time
+    ArenaScope scope;
+    glm::vec3* positions = scope.Arena.Allocate<glm::vec3>(out.VertexCount);
+    VertexAttributes* attributes = scope.Arena.Allocate<VertexAttributes>(out.VertexCount);
+    SplitVertexStreams(primitive.Vertices, out.VertexCount, positions, attributes);
+
+    out.PositionBuffer = std::make_shared<Buffer>(out.VertexCount * sizeof(glm::vec3), sizeof(glm::vec3), BufferType::Storage, ResourceName(name, " Position Buffer"));
+    out.PositionBuffer->BuildSRV();
+    Uploader::EnqueueBufferUpload(positions, out.PositionBuffer->GetSize(), out.PositionBuffer);
+
+    if (options.CompactVertices) {
+        CompactAttributes* compact = scope.Arena.Allocate<CompactAttributes>(out.VertexCount);
+        for (uint32_t i = 0; i < out.VertexCount; i++) {
+            compact[i] = EncodeAttributes(attributes[i]);
         }
+        out.Compact = true;
 
-        outMaterial.AlphaTested = (material->alpha_mode != cgltf_alpha_mode_opaque);
+        out.AttributeBuffer = std::make_shared<Buffer>(out.VertexCount * sizeof(CompactAttributes), sizeof(CompactAttributes), BufferType::Storage, ResourceName(name, " Attribute Buffer"));
+        out.AttributeBuffer->BuildSRV();
+        Uploader::EnqueueBufferUpload(compact, out.AttributeBuffer->GetSize(), out.AttributeBuffer);
     } else {
-        outMaterial.Albedo = RendererTools::Get("BlackTexture")->Texture;
-        outMaterial.AlbedoView = RendererTools::Get("BlackTexture")->GetView(ViewType::ShaderResource);
+        out.AttributeBuffer = std::make_shared<Buffer>(out.VertexCount * sizeof(VertexAttributes), sizeof(VertexAttributes), BufferType::Storage, ResourceName(name, " Attribute Buffer"));
+        out.AttributeBuffer->BuildSRV();
+        Uploader::EnqueueBufferUpload(attributes, out.AttributeBuffer->GetSize(), out.AttributeBuffer);
     }
 
-    Materials.push_back(outMaterial);
+    out.GeometryStructure = std::make_shared<BLAS>(out.PositionBuffer, out.IndexBuffer, out.VertexCount, out.IndexCount, ResourceName(name, " BLAS"));
+
+    // Nothing selects a LOD yet, only the errors are kept (see GLTFPrimitive::SelectLOD)
+    out.LODLevels.assign(primitive.LODLevels, primitive.LODLevels + primitive.LODCount);
+
+    if (options.BuildClusters) {
+        out.Clusters = std::make_shared<ClusterData>();
+        ClusterBuilder::Build(primitive.Vertices, out.VertexCount, primitive.Indices, out.IndexCount, *out.Clusters);
+#ifndef NDEBUG
+        ASSERT(ClusterBuilder::Validate(*out.Clusters, primitive.Indices, out.IndexCount), "Cluster decomposition doesn't cover every triangle exactly once!");
+#endif
+        ClusterCount += static_cast<uint32_t>(out.Clusters->Clusters.size());
+    }
 
-    Uploader::EnqueueBufferUpload(vertices.data(), out.VertexBuffer->GetSize(), out.VertexBuffer);
-    Uploader::EnqueueBufferUpload(indices.data(), out.IndexBuffer->GetSize(), out.IndexBuffer);
     Uploader::EnqueueAccelerationStructureBuild(out.GeometryStructure);
 
     out.Instance = {};
     out.Instance.AccelerationStructure = out.GeometryStructure->GetAddress();
     out.Instance.InstanceMask = 1;
     out.Instance.InstanceID = 0;
-    out.Instance.Transform = glm::mat3x4(glm::transpose(node->Transform));
     out.Instance.Flags = 0x4;
 
     VertexCount += out.VertexCount;
     IndexCount += out.IndexCount;
 
-    node->Primitives.push_back(out);
+    return true;
 }
 
-void GLTF::TraverseNode(GLTFNode* root, const std::function<void(GLTFNode*)>& fn)
+GLTFMaterial GLTF::ProcessMaterial(const GLTFMaterialDesc* material)
 {
-    if (!root) {
-        return;
-    }
-    fn(root);
+    /// @note(ame): load and create textures
+    GLTFMaterial outMaterial = {};
+    if (material) {
+        if (!material->Albedo.empty()) {
+            TextureFormat viewFormat;
+            outMaterial.Albedo = TextureCache::Get(Directory + '/' + material->Albedo, TextureKind::Albedo, &viewFormat);
+            outMaterial.AlbedoView = std::make_shared<View>(outMaterial.Albedo, ViewType::ShaderResource, ViewDimension::Texture, viewFormat);
+        } else {
+            outMaterial.Albedo = RendererTools::Get("BlackTexture")->Texture;
+            outMaterial.AlbedoView = RendererTools::Get("BlackTexture")->GetView(ViewType::ShaderResource);
+        }
 
-    if (!root->Children.empty()) {
-        for (GLTFNode* child : root->Children) {
-            TraverseNode(child, fn);
+        if (!material->Normal.empty()) {
+            TextureFormat viewFormat;
+            outMaterial.Normal = TextureCache::Get(Directory + '/' + material->Normal, TextureKind::Normal, &viewFormat);
+            outMaterial.NormalView = std::make_shared<View>(outMaterial.Normal, ViewType::ShaderResource, ViewDimension::Texture, viewFormat);
         }
+
+        if (!material->PBR.empty()) {
+            TextureFormat viewFormat;
+            outMaterial.PBR = TextureCache::Get(Directory + '/' + material->PBR, TextureKind::MetallicRoughness, &viewFormat);
+            outMaterial.PBRView = std::make_shared<View>(outMaterial.PBR, ViewType::ShaderResource, ViewDimension::Texture, viewFormat);
+        }
+
+        outMaterial.AlphaTested = material->AlphaTested;
+        outMaterial.OwnsAlbedoView = !material->Albedo.empty();
+    } else {
+        outMaterial.Albedo = RendererTools::Get("BlackTexture")->Texture;
+        outMaterial.AlbedoView = RendererTools::Get("BlackTexture")->GetView(ViewType::ShaderResource);
     }
+    return outMaterial;
 }
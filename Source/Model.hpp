@@ -10,9 +10,16 @@
 
 #include <cgltf.h>
 #include <glm/glm.hpp>
-#include <functional>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
 
 #include "Util/TangentCalculator.hpp"
+#include "Util/TangentSpace.hpp"
+#include "Util/MeshLocality.hpp"
+#include "Util/VertexWelder.hpp"
+#include "Util/ClusterBuilder.hpp"
+#include "Util/MeshSimplifier.hpp"
 
 struct RaytracingMaterial
 {
@@ -34,11 +41,18 @@ struct GLTFMaterial
     std::shared_ptr<View> PBRView;
 
     bool AlphaTested = false;
+    /// @note(ame): false when AlbedoView is the shared black texture view.
+    bool OwnsAlbedoView = false;
+
+    /// @note(ame): views this material created, the fallback black view isn't counted.
+    uint32_t ViewCount() const { return (OwnsAlbedoView ? 1 : 0) + (NormalView ? 1 : 0) + (PBRView ? 1 : 0); }
 };
 
 struct GLTFPrimitive
 {
-    std::shared_ptr<Buffer> VertexBuffer;
+    /// @note(ame): float3 positions, fed to the BLAS. Shading attributes live in AttributeBuffer (VertexAttributes or CompactAttributes).
+    std::shared_ptr<Buffer> PositionBuffer;
+    std::shared_ptr<Buffer> AttributeBuffer;
     std::shared_ptr<Buffer> IndexBuffer;
 
     RaytracingInstance Instance;
@@ -47,18 +61,177 @@ struct GLTFPrimitive
     uint32_t VertexCount;
     uint32_t IndexCount;
     int MaterialIndex;
+
+    /// @note(ame): object space AABB of the vertices.
+    glm::vec3 BoundsMin;
+    glm::vec3 BoundsMax;
+
+    bool Compact = false;
+    /// @note(ame): only built with GLTFLoadOptions::BuildClusters, shared by every instance of the primitive.
+    std::shared_ptr<ClusterData> Clusters;
+
+    /// @note(ame): errors of the cooked LOD chain, level i + 1 is LODLevels[i]. Empty unless built with GLTFLoadOptions::BuildLODs.
+    /// Only the errors are kept: no pass selects a level yet, so the simplified index buffers and BLASes aren't uploaded.
+    std::vector<LODLevel> LODLevels;
+
+    /// @note(ame): footprint is world space, transform is the instance's. 0 for the full primitive, i + 1 for LODLevels[i].
+    uint32_t SelectLOD(float footprint, const glm::mat4& transform) const { return MeshSimplifier::SelectLOD(LODLevels.data(), static_cast<uint32_t>(LODLevels.size()), footprint, MeshSimplifier::MaxScale(transform)); }
 };
 
-struct GLTFNode
+/// @note(ame): CPU side result of decoding a primitive, before any GPU resource exists.
+struct GLTFPrimitiveData
 {
-    std::vector<GLTFPrimitive> Primitives;
+    std::vector<Vertex> Vertices;
+    std::vector<uint32_t> Indices;
+    bool Valid = false;
+
+    WeldStats Weld;
+    std::vector<uint32_t> LODIndices;
+    std::vector<LODLevel> LODLevels;
+    /// @note(ame): index locality before and after MeshLocality::Optimize, only filled when a reorder ran.
+    LocalityStats LocalityBefore;
+    LocalityStats LocalityAfter;
+};
 
-    std::string Name = "";
-    glm::mat4 Transform;
-    GLTFNode* Parent = nullptr;
-    std::vector<GLTFNode*> Children = {};
+/*
+    Flat description of a model: what the cgltf path decodes and what a cook stores.
+    Vertex/index pointers either point into decoded GLTFPrimitiveData or straight into a mapped cook file.
+*/
 
-    GLTFNode() = default;
+struct GLTFPrimitiveDesc
+{
+    const Vertex* Vertices = nullptr;
+    const uint32_t* Indices = nullptr;
+    uint32_t VertexCount = 0;
+    uint32_t IndexCount = 0;
+    int Material = -1;
+
+    const uint32_t* LODIndices = nullptr;
+    const LODLevel* LODLevels = nullptr;
+    uint32_t LODIndexCount = 0;
+    uint32_t LODCount = 0;
+};
+
+struct GLTFMeshDesc
+{
+    uint32_t FirstPrimitive = 0;
+    uint32_t PrimitiveCount = 0;
+};
+
+/// @note(ame): texture paths are relative to the model directory, empty when the slot is unused.
+struct GLTFMaterialDesc
+{
+    std::string Albedo;
+    std::string Normal;
+    std::string PBR;
+    bool AlphaTested = false;
+};
+
+/// @note(ame): nodes are stored parents first, Parent == -1 means the node hangs off the root.
+struct GLTFNodeDesc
+{
+    std::string Name;
+    int Parent = -1;
+    int Mesh = -1;
+    glm::mat4 Transform = glm::mat4(1.0f);
+};
+
+struct GLTFSceneDesc
+{
+    std::vector<GLTFNodeDesc> Nodes;
+    std::vector<GLTFMeshDesc> Meshes;
+    std::vector<GLTFPrimitiveDesc> Primitives;
+    std::vector<GLTFMaterialDesc> Materials;
+
+    /// @note(ame): external files (buffers, extracted images) the model was built from, relative to the model directory.
+    std::vector<std::string> Dependencies;
+};
+
+/*
+    Node hierarchy as parallel arrays in topological order: a parent always comes before its children, node 0 is the root.
+    World transforms and bounds come out of a single forward pass, walking it is a plain loop.
+*/
+
+struct GLTFHierarchy
+{
+    std::vector<std::string> Names;
+    /// @note(ame): -1 for the root only.
+    std::vector<int> Parents;
+    std::vector<glm::mat4> LocalTransforms;
+    std::vector<glm::mat4> WorldTransforms;
+    /// @note(ame): world space AABB of the node's own primitives, min > max when it has none.
+    std::vector<glm::vec3> BoundsMin;
+    std::vector<glm::vec3> BoundsMax;
+    /// @note(ame): the node's primitives are GLTF::Primitives[FirstPrimitive, FirstPrimitive + PrimitiveCount).
+    std::vector<uint32_t> FirstPrimitive;
+    std::vector<uint32_t> PrimitiveCount;
+
+    uint32_t Size() const { return static_cast<uint32_t>(Parents.size()); }
+
+    void Reserve(size_t count);
+    uint32_t Push(const std::string& name, int parent, const glm::mat4& localTransform);
+};
+
+struct GLTFLoadOptions
+{
+    /// @note(ame): decode primitives on the job system, then commit them in file order.
+    bool Parallel = true;
+    /// @note(ame): read/write a binary cook next to the asset (see Cache/ModelCooker.hpp).
+    bool UseCook = true;
+    /// @note(ame): upload CompactAttributes (16 bytes) instead of VertexAttributes (44 bytes), see Util/VertexQuantization.hpp.
+    bool CompactVertices = false;
+    /// @note(ame): merge duplicate vertices before tangent generation, baked into the cook (see Util/VertexWelder.hpp).
+    /// Opt-in, it changes vertex counts and indices of the loaded model.
+    bool Weld = false;
+    WeldOptions WeldTolerance;
+    /// @note(ame): how per-vertex tangent frames are generated, baked into the cook (see Util/TangentSpace.hpp).
+    TangentMode Tangents = TangentMode::Accumulated;
+    /// @note(ame): triangle/vertex reorder applied after decode, baked into the cook (see Util/MeshLocality.hpp).
+    /// Opt-in, the default keeps the file's vertex and index order.
+    TriangleOrder Reorder = TriangleOrder::Original;
+    /// @note(ame): split every primitive into meshlets with bounds and normal cones (see Util/ClusterBuilder.hpp).
+    bool BuildClusters = false;
+    /// @note(ame): QEM simplified LOD chain per primitive, baked into the cook (see Util/MeshSimplifier.hpp).
+    /// CPU only: the levels are neither uploaded nor given a BLAS, rays keep tracing the full mesh.
+    bool BuildLODs = false;
+    LODOptions LODSettings;
+
+    /// @note(ame): everything that changes the cooked geometry, a cook written with a different key is rebuilt.
+    uint64_t CookKey() const;
+};
+
+struct ModelCook;
+
+/// @note(ame): decode progress of a load in flight, safe to read from any thread.
+struct GLTFLoadProgress
+{
+    std::atomic<uint32_t> PrimitiveCount = 0;
+    std::atomic<uint32_t> PrimitivesDecoded = 0;
+};
+
+/*
+    CPU half of a load. GLTF::Prepare fills it on any thread without touching the RHI,
+    GLTF::Finish turns it into buffers, BLASes and textures on the main thread.
+*/
+struct GLTFPreparedModel
+{
+    std::string Path;
+    GLTFLoadOptions Options;
+    bool Cooked = false;
+    float PrepareMs = 0.0f;
+
+    /// @note(ame): warm start, the scene points into the mapped cook.
+    std::unique_ptr<ModelCook> Cook;
+    /// @note(ame): cold start, the scene points into Storage.
+    GLTFSceneDesc Parsed;
+    std::vector<GLTFPrimitiveData> Storage;
+
+    GLTFPreparedModel();
+    ~GLTFPreparedModel();
+
+    const GLTFSceneDesc& GetScene() const;
+    /// @note(ame): frees the CPU copy (and unmaps the cook), call once GLTF::Finish is done with it.
+    void Release();
 };
 
 class GLTF
@@ -67,19 +240,86 @@ public:
     std::string Path;
     std::string Directory;
 
-    GLTFNode* Root = nullptr;
+    GLTFHierarchy Nodes;
+    /// @note(ame): placed primitives, grouped by node in node order. Instances of one mesh share buffers and BLAS.
+    std::vector<GLTFPrimitive> Primitives;
     std::vector<GLTFMaterial> Materials;
     std::shared_ptr<Buffer> MaterialBuffer;
+    /// @note(ame): what MaterialBuffer holds. Textures still decoding are swapped for placeholders, see RefreshMaterials.
+    std::vector<RaytracingMaterial> MaterialEntries;
 
     uint32_t VertexCount = 0;
     uint32_t IndexCount = 0;
+    uint32_t ClusterCount = 0;
+
+    /// @note(ame): meshes referenced by several nodes share their buffers/BLAS, these track what that saved.
+    uint32_t SharedMeshInstances = 0;
+    uint64_t SharedGeometryBytesSaved = 0;
+
+    /// @note(ame): primitives share one GLTFMaterial per glTF material. References/ViewReferences are what one material per primitive would have cost.
+    uint32_t MaterialReferences = 0;
+    uint32_t MaterialViewReferences = 0;
+    uint32_t MaterialViewCount = 0;
 
-    void Load(const std::string& path);
-    ~GLTF();
+    /// @note(ame): union of the node bounds, model space.
+    glm::vec3 BoundsMin;
+    glm::vec3 BoundsMax;
 
-    void TraverseNode(GLTFNode* root, const std::function<void(GLTFNode*)>& fn);
+    void Load(const std::string& path, const GLTFLoadOptions& options = {});
+
+    /// @note(ame): the two halves of Load. Prepare is thread safe and never touches the RHI, Finish has to run on the main thread.
+    static void Prepare(const std::string& path, const GLTFLoadOptions& options, GLTFPreparedModel& out, GLTFLoadProgress* progress = nullptr);
+    void Finish(GLTFPreparedModel& prepared);
+
+    /// @note(ame): main thread, after TextureCache::Update. Points the entries of materials whose textures got their upload queued
+    /// at the real views, returns true if anything changed (flush the uploader).
+    /// MaterialBuffer is then a new buffer, frames in flight still read the previous one: keep it alive until they retire.
+    bool RefreshMaterials();
+
+    /// @note(ame): recomputes world transforms, node/model bounds and every Instance.Transform from the local transforms.
+    void UpdateWorldTransforms();
+
+    /// @note(ame): visitor(uint32_t node), parents before children.
+    template<typename Visitor>
+    void ForEachNode(Visitor&& visitor)
+    {
+        for (uint32_t node = 0; node < Nodes.Size(); node++) {
+            visitor(node);
+        }
+    }
+
+    /// @note(ame): visitor(GLTFPrimitive&, const glm::mat4& world) for every placed primitive, in node order.
+    template<typename Visitor>
+    void ForEachPrimitive(Visitor&& visitor)
+    {
+        for (uint32_t node = 0; node < Nodes.Size(); node++) {
+            const glm::mat4& world = Nodes.WorldTransforms[node];
+            GLTFPrimitive* primitives = Primitives.data() + Nodes.FirstPrimitive[node];
+            for (uint32_t i = 0; i < Nodes.PrimitiveCount[node]; i++) {
+                visitor(primitives[i], world);
+            }
+        }
+    }
 private:
-    void ProcessPrimitive(cgltf_primitive *primitive, GLTFNode *node);
-    void ProcessNode(cgltf_node *node, GLTFNode *mnode);
-    void FreeNodes(GLTFNode* node);
+    struct ParseState
+    {
+        std::unordered_map<cgltf_mesh*, int> Meshes;
+        std::unordered_map<cgltf_material*, int> Materials;
+        std::unordered_map<cgltf_image*, std::string> Images;
+        std::vector<cgltf_primitive*> Primitives;
+        std::string Path;
+        cgltf_data* Data = nullptr;
+    };
+
+    static void Parse(const std::string& path, const GLTFLoadOptions& options, GLTFSceneDesc& desc, std::vector<GLTFPrimitiveData>& storage, GLTFLoadProgress* progress);
+    void Commit(const GLTFSceneDesc& desc, const GLTFLoadOptions& options);
+
+    static void DecodePrimitive(cgltf_primitive *primitive, const GLTFLoadOptions& options, GLTFPrimitiveData& out);
+    bool ProcessPrimitive(const GLTFPrimitiveDesc& primitive, const std::string& name, const GLTFLoadOptions& options, GLTFPrimitive& out);
+    GLTFMaterial ProcessMaterial(const GLTFMaterialDesc* material);
+    static void ProcessNode(cgltf_node *node, int parent, GLTFSceneDesc& desc, ParseState& state);
+    static int ProcessMaterial(cgltf_material *material, GLTFSceneDesc& desc, ParseState& state);
+    /// @note(ame): GLB/buffer view images get written next to the model once, TextureCache and the cook only deal in paths.
+    /// The extracted file becomes a dependency of the cook, deleting or editing it rebuilds the cook, which extracts it again.
+    static std::string ExtractImage(cgltf_image* image, GLTFSceneDesc& desc, ParseState& state);
 };
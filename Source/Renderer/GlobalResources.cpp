@@ -7,20 +7,29 @@
 
 void GlobalResources::PushModel(GLTF& gltf)
 {
-    gltf.TraverseNode(gltf.Root, [&](GLTFNode* root) {
-        for (auto& primitive : root->Primitives) {
-            primitive.Instance.InstanceID = mInstanceCount;
-            
-            Instance instance;
-            instance.VertexBuffer = primitive.VertexBuffer->SRV();
-            instance.IndexBuffer = primitive.IndexBuffer->SRV();
-            instance.MaterialIndex = primitive.MaterialIndex;
-            instance.MaterialBuffer = gltf.MaterialBuffer->SRV();
+    gltf.ForEachPrimitive([&](GLTFPrimitive& primitive, const glm::mat4&) {
+        primitive.Instance.InstanceID = mInstanceCount;
+        
+        Instance instance;
+        instance.PositionBuffer = primitive.PositionBuffer->SRV();
+        instance.AttributeBuffer = primitive.AttributeBuffer->SRV();
+        instance.IndexBuffer = primitive.IndexBuffer->SRV();
+        instance.MaterialIndex = primitive.MaterialIndex;
+        instance.MaterialBuffer = gltf.MaterialBuffer->SRV();
+        instance.VertexFormat = primitive.Compact ? VertexFormatCompact : VertexFormatFull;
+        instance.Pad[0] = 0;
+        instance.Pad[1] = 0;
 
-            mInstances.push_back(instance);
-            
-            mInstanceCount++;
-        }
+        mInstances.push_back(instance);
+        
+        mInstanceCount++;
+    });
+}
+
+void GlobalResources::RefreshModel(GLTF& gltf)
+{
+    gltf.ForEachPrimitive([&](GLTFPrimitive& primitive, const glm::mat4&) {
+        mInstances[primitive.Instance.InstanceID].MaterialBuffer = gltf.MaterialBuffer->SRV();
     });
 }
 
@@ -13,12 +13,23 @@
     With the help of bindless resources, we can store materials and instance data into one huge ass array that we can then use in our raytracing shader.
 */
 
+enum InstanceVertexFormat : int
+{
+    VertexFormatFull = 0,
+    VertexFormatCompact = 1
+};
+
+/// @note(ame): mirrored in Shaders/Raytrace.hlsl, keep the layouts in sync.
 struct Instance
 {
-    int VertexBuffer;
+    int PositionBuffer;
+    int AttributeBuffer;
     int IndexBuffer;
     int MaterialIndex;
+
     int MaterialBuffer;
+    int VertexFormat;
+    int Pad[2];
 };
 
 class GlobalResources
@@ -27,6 +38,8 @@ public:
     std::shared_ptr<Buffer> InstanceBuffer;
 
     void PushModel(GLTF& gltf);
+    /// @note(ame): points the model's instances at its current MaterialBuffer, Build() uploads them.
+    void RefreshModel(GLTF& gltf);
     void Build();
 private:
     std::vector<Instance> mInstances;
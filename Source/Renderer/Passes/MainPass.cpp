@@ -19,6 +19,9 @@ struct RayPayload
     glm::vec3 NewDirection;
     glm::vec3 NewOrigin;
 
+    float ConeWidth;
+    float ConeSpread;
+
     glm::uvec2 rng;
 };
 
@@ -56,6 +59,11 @@ MainPass::MainPass()
 
 void MainPass::Render(Frame& frame, Scene& scene)
 {
+    // Nothing committed yet (async load in flight), there is no TLAS to trace against
+    if (!scene.TopLevelAS) {
+        return;
+    }
+
     auto out = RendererTools::Get("RTOutput");
     auto cam = RendererTools::Get("CameraBuffer");
     auto sampler = RendererTools::Get("TextureSampler");
@@ -4,9 +4,19 @@
 //
 
 #include "Scene.hpp"
+#include "Cache/TextureCache.hpp"
+#include "Util/JobSystem.hpp"
 
 Scene::~Scene()
 {
+    // Jobs write into their EntityLoad, let them finish before anything goes away
+    for (auto& load : PendingLoads) {
+        if (load->Job.valid()) {
+            load->Job.wait();
+        }
+    }
+    PendingLoads.clear();
+
     for (auto& entity : Entities) {
         delete entity;
     }
@@ -16,17 +26,18 @@ Scene::~Scene()
 void Scene::Build()
 {
     Resources.Build();
+    Instances.clear();
 
+    // Shared models are walked once per entity, only the instances are per entity
     for (auto& entity : Entities) {
-        entity->Model.TraverseNode(entity->Model.Root, [&](GLTFNode* node){
-            for (auto& primitive : node->Primitives) {
-                GLTFMaterial material = entity->Model.Materials[primitive.MaterialIndex];
-
-                glm::mat4 transform = glm::mat4(primitive.Instance.Transform) * entity->Transform;
-                primitive.Instance.Transform = glm::mat3x4(transform);
-                primitive.Instance.Flags = material.AlphaTested ? D3D12_RAYTRACING_INSTANCE_FLAG_FORCE_NON_OPAQUE : D3D12_RAYTRACING_INSTANCE_FLAG_FORCE_OPAQUE;
-                Instances.push_back(primitive.Instance);
-            }
+        GLTF& model = *entity->Model;
+        model.ForEachPrimitive([&](GLTFPrimitive& primitive, const glm::mat4& world) {
+            const GLTFMaterial& material = model.Materials[primitive.MaterialIndex];
+
+            RaytracingInstance instance = primitive.Instance;
+            instance.Transform = glm::mat3x4(glm::transpose(entity->Transform * world));
+            instance.Flags = material.AlphaTested ? D3D12_RAYTRACING_INSTANCE_FLAG_FORCE_NON_OPAQUE : D3D12_RAYTRACING_INSTANCE_FLAG_FORCE_OPAQUE;
+            Instances.push_back(instance);
         });
     }
 
@@ -39,12 +50,190 @@ void Scene::Build()
 
 Entity* Scene::PushEntity(glm::mat4 transform, const std::string& path)
 {
+    bool created = false;
+
     Entity* entity = new Entity;
-    entity->Model.Load(path);
+    entity->Model = ModelCache::Get(path, {}, &created);
     entity->Transform = transform;
     Entities.push_back(entity);
 
-    Resources.PushModel(entity->Model);
+    // A shared model already has its instances registered, their InstanceIDs are valid for every entity using it
+    if (created) {
+        Resources.PushModel(*entity->Model);
+    }
 
     return entity;
 }
+
+EntityLoadHandle Scene::PushEntityAsync(glm::mat4 transform, const std::string& path, const GLTFLoadOptions& options)
+{
+    EntityLoadHandle load = std::make_shared<EntityLoad>();
+    load->Path = path;
+    load->Transform = transform;
+    load->Options = options;
+
+    // Already loaded: nothing to decode, it gets committed at the next Update like any other load
+    std::string key = ModelCache::Key(path, options);
+    load->Model = ModelCache::Find(path, options);
+    if (load->Model) {
+        load->State = EntityLoadState::Ready;
+        PendingLoads.push_back(load);
+        return load;
+    }
+
+    // Already being decoded: wait for that load and share its model
+    load->Source = FindPendingLoad(key);
+    if (load->Source) {
+        PendingLoads.push_back(load);
+        return load;
+    }
+
+    // The job only touches its own EntityLoad, nothing on the RHI side
+    EntityLoad* raw = load.get();
+    load->Job = JobSystem::Submit([raw]() {
+        raw->State = EntityLoadState::Decoding;
+        GLTF::Prepare(raw->Path, raw->Options, raw->Prepared, &raw->Progress);
+        raw->State = EntityLoadState::Ready;
+    });
+
+    PendingLoads.push_back(load);
+    return load;
+}
+
+void Scene::Update()
+{
+    // RHI::Begin waits for the frame that used the same slot, FRAMES_IN_FLIGHT updates later nothing reads a retired buffer anymore
+    UpdateCount++;
+    std::erase_if(Retired, [&](const RetiredBuffer& retired) { return UpdateCount - retired.Frame >= FRAMES_IN_FLIGHT; });
+
+    bool committed = false;
+    for (auto it = PendingLoads.begin(); it != PendingLoads.end();) {
+        EntityLoad& load = **it;
+
+        // Sources are queued before the loads waiting on them, so they got committed earlier in this loop
+        if (load.Source && load.Source->IsDone()) {
+            load.Model = load.Source->Result->Model;
+            load.State = EntityLoadState::Ready;
+        }
+        if (load.State != EntityLoadState::Ready) {
+            ++it;
+            continue;
+        }
+
+        if (load.Job.valid()) {
+            load.Job.get();
+        }
+        Commit(load);
+        committed = true;
+        it = PendingLoads.erase(it);
+    }
+
+    // Textures decoded since the last frame, committed models may have queued more of them
+    bool uploaded = TextureCache::Update();
+
+    // Materials sample placeholders until their textures are queued, swap the real views in. Shared models refresh once
+    bool swapped = false;
+    if (uploaded) {
+        for (auto& entity : Entities) {
+            GLTF& model = *entity->Model;
+            std::shared_ptr<Buffer> previous = model.MaterialBuffer;
+            if (model.RefreshMaterials()) {
+                Retire(previous);
+                Resources.RefreshModel(model);
+                swapped = true;
+            }
+        }
+    }
+    if (!committed && !uploaded) {
+        return;
+    }
+
+    if (committed) {
+        // Frames in flight still reference the old instance buffers and TLAS, which Build() frees
+        RHI::Wait();
+        Build();
+    } else if (swapped) {
+        // Same TLAS, only the instances point at new material buffers
+        Retire(Resources.InstanceBuffer);
+        Resources.Build();
+    }
+    Uploader::Flush();
+    if (committed || swapped) {
+        RHI::ResetFrameCount();
+    }
+}
+
+void Scene::Commit(EntityLoad& load)
+{
+    Entity* entity = new Entity;
+    entity->Transform = load.Transform;
+    Entities.push_back(entity);
+
+    // PushEntity may have loaded the same model while this one was decoding, the decoded copy is dropped then
+    GLTFHandle model = load.Model ? load.Model : ModelCache::Find(load.Path, load.Options);
+    if (!model) {
+        model = std::make_shared<GLTF>();
+        model->Finish(load.Prepared);
+        ModelCache::Insert(load.Path, load.Options, model);
+
+        Resources.PushModel(*model);
+    }
+    entity->Model = model;
+
+    // Drop the decoded arrays/mapped cook now, the GPU has its own copy queued
+    load.Prepared.Release();
+    load.Result = entity;
+    load.State = EntityLoadState::Committed;
+}
+
+void Scene::Retire(const std::shared_ptr<Buffer>& buffer)
+{
+    if (buffer) {
+        Retired.push_back({ buffer, UpdateCount });
+    }
+}
+
+std::shared_ptr<EntityLoad> Scene::FindPendingLoad(const std::string& key) const
+{
+    for (auto& load : PendingLoads) {
+        if (load->Job.valid() && ModelCache::Key(load->Path, load->Options) == key) {
+            return load;
+        }
+    }
+    return nullptr;
+}
+
+float Scene::GetLoadProgress() const
+{
+    if (PendingLoads.empty()) {
+        return 1.0f;
+    }
+
+    float progress = 0.0f;
+    for (auto& load : PendingLoads) {
+        progress += load->GetProgress();
+    }
+    return progress / PendingLoads.size();
+}
+
+float EntityLoad::GetProgress() const
+{
+    // Source is set before the handle is returned and never changes, fine to follow from any thread
+    if (Source && State == EntityLoadState::Queued) {
+        return Source->GetProgress() * 0.99f;
+    }
+
+    switch (State.load()) {
+        case EntityLoadState::Queued:
+            return 0.0f;
+        case EntityLoadState::Decoding: {
+            uint32_t count = Progress.PrimitiveCount;
+            return count ? 0.99f * Progress.PrimitivesDecoded / count : 0.0f;
+        }
+        case EntityLoadState::Ready:
+            return 0.99f;
+        case EntityLoadState::Committed:
+            return 1.0f;
+    }
+    return 0.0f;
+}
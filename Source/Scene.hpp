@@ -8,8 +8,12 @@
 #include <Oslo/Oslo.hpp>
 
 #include "Model.hpp"
+#include "Cache/ModelCache.hpp"
 #include "Renderer/GlobalResources.hpp"
 
+#include <atomic>
+#include <future>
+
 struct CameraInfo
 {
     glm::mat4 View;
@@ -22,9 +26,45 @@ struct Entity
     USE_TRACKING_ALLOCATOR;
 
     glm::mat4 Transform;
-    GLTF Model;
+    /// @note(ame): shared with every entity placing the same asset, see Cache/ModelCache.hpp.
+    GLTFHandle Model;
 };
 
+enum class EntityLoadState : uint32_t
+{
+    Queued,
+    Decoding,
+    /// @note(ame): CPU work done, waiting for the next Scene::Update to commit it.
+    Ready,
+    Committed
+};
+
+/// @note(ame): shared between the caller, the loading job and the scene. Everything but Result is safe to read from any thread.
+struct EntityLoad
+{
+    std::string Path;
+    glm::mat4 Transform;
+    GLTFLoadOptions Options;
+
+    std::atomic<EntityLoadState> State = EntityLoadState::Queued;
+    GLTFLoadProgress Progress;
+    GLTFPreparedModel Prepared;
+    std::future<void> Job;
+
+    /// @note(ame): no job of our own when the model is cached (Model) or already being decoded by an earlier load (Source).
+    GLTFHandle Model;
+    std::shared_ptr<EntityLoad> Source;
+
+    /// @note(ame): main thread only, set once State is Committed.
+    Entity* Result = nullptr;
+
+    /// @note(ame): 0 -> 1, decoded primitives over total, 1 once committed.
+    float GetProgress() const;
+    bool IsDone() const { return State == EntityLoadState::Committed; }
+};
+
+using EntityLoadHandle = std::shared_ptr<EntityLoad>;
+
 class Scene
 {
 public:
@@ -34,11 +74,35 @@ public:
     void Build();
     Entity* PushEntity(glm::mat4 transform, const std::string& path);
 
+    /// @note(ame): parse/decode/tangents run on the job system, the entity shows up at the first Update after they finish.
+    EntityLoadHandle PushEntityAsync(glm::mat4 transform, const std::string& path, const GLTFLoadOptions& options = {});
+    /// @note(ame): main thread, at a frame boundary. Commits finished loads, then rebuilds the instances and the TLAS if anything changed.
+    /// Only a commit waits for the GPU, texture uploads and the material swaps they trigger go to fresh resources.
+    void Update();
+
+    uint32_t GetPendingLoadCount() const { return static_cast<uint32_t>(PendingLoads.size()); }
+    /// @note(ame): combined progress of the loads in flight, 1 when there are none.
+    float GetLoadProgress() const;
+
     std::shared_ptr<TLAS> TopLevelAS;
     GlobalResources Resources;
     CameraInfo CamInfo;
 private:
+    void Commit(EntityLoad& load);
+    std::shared_ptr<EntityLoad> FindPendingLoad(const std::string& key) const;
+    /// @note(ame): keeps a buffer the frames in flight may still read alive until they're done with it.
+    void Retire(const std::shared_ptr<Buffer>& buffer);
+
+    struct RetiredBuffer
+    {
+        std::shared_ptr<Buffer> Resource;
+        uint64_t Frame;
+    };
+
     std::vector<Entity*> Entities;
+    std::vector<EntityLoadHandle> PendingLoads;
     std::vector<RaytracingInstance> Instances;
     std::shared_ptr<Buffer> InstanceBuffer;
+    std::vector<RetiredBuffer> Retired;
+    uint64_t UpdateCount = 0;
 };
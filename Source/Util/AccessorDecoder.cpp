@@ -0,0 +1,281 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-12 15:48:22
+//
+
+#include "AccessorDecoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define ACCESSOR_DECODER_SSE2
+#endif
+
+template<typename T>
+static inline T ReadUnaligned(const uint8_t* src)
+{
+    T value;
+    memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+template<typename T>
+static inline float ConvertComponent(T value, bool normalized)
+{
+    if (!normalized) {
+        return static_cast<float>(value);
+    }
+
+    // Same expressions as cgltf_component_read_float
+    if constexpr (std::is_same_v<T, int8_t>) return value / static_cast<float>(127);
+    if constexpr (std::is_same_v<T, uint8_t>) return value / static_cast<float>(255);
+    if constexpr (std::is_same_v<T, int16_t>) return value / static_cast<float>(32767);
+    if constexpr (std::is_same_v<T, uint16_t>) return value / static_cast<float>(65535);
+    return static_cast<float>(value);
+}
+
+#ifdef ACCESSOR_DECODER_SSE2
+/// @note(ame): 4 components widened to float, whatever N is. Callers make sure the extra bytes are inside the view.
+template<typename T>
+static inline __m128 LoadComponents4(const uint8_t* src)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v;
+    if constexpr (sizeof(T) == 1) {
+        int32_t packed;
+        memcpy(&packed, src, sizeof(packed));
+        v = _mm_cvtsi32_si128(packed);
+        if constexpr (std::is_signed_v<T>) {
+            // Replicate each byte up to the top of its lane, then shift it back down with sign extension
+            v = _mm_unpacklo_epi8(v, v);
+            v = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 24);
+        } else {
+            v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+        }
+    } else {
+        v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+        if constexpr (std::is_signed_v<T>) {
+            v = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        } else {
+            v = _mm_unpacklo_epi16(v, zero);
+        }
+    }
+    return _mm_cvtepi32_ps(v);
+}
+
+/// @note(ame): how many leading elements can over-read up to loadBytes without leaving the accessor's last element.
+static inline size_t WideElementCount(size_t count, size_t stride, size_t elementBytes, size_t loadBytes)
+{
+    if (elementBytes >= loadBytes) {
+        return count;
+    }
+    size_t tailElements = (loadBytes - elementBytes + stride - 1) / stride;
+    return count > tailElements ? count - tailElements : 0;
+}
+#endif
+
+template<typename T, uint32_t N>
+static void DecodeStrided(const uint8_t* src, size_t srcStride, size_t count, bool normalized, float* dst, size_t dstStride)
+{
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    size_t i = 0;
+#ifdef ACCESSOR_DECODER_SSE2
+    // KHR_mesh_quantization attributes: widen a whole element at once, division kept so results match ConvertComponent bit for bit
+    if constexpr (sizeof(T) <= 2) {
+        const __m128 scale = _mm_set1_ps(ConvertComponent(std::numeric_limits<T>::max(), false));
+        size_t wide = WideElementCount(count, srcStride, N * sizeof(T), 4 * sizeof(T));
+        for (; i < wide; i++) {
+            __m128 values = LoadComponents4<T>(src);
+            if (normalized) {
+                values = _mm_div_ps(values, scale);
+            }
+
+            float lanes[4];
+            _mm_storeu_ps(lanes, values);
+            memcpy(out, lanes, N * sizeof(float));
+
+            src += srcStride;
+            out += dstStride;
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        float values[N];
+        for (uint32_t c = 0; c < N; c++) {
+            values[c] = ConvertComponent(ReadUnaligned<T>(src + c * sizeof(T)), normalized);
+        }
+        memcpy(out, values, sizeof(values));
+
+        src += srcStride;
+        out += dstStride;
+    }
+}
+
+template<uint32_t N>
+static void DecodeStridedFloat(const uint8_t* src, size_t srcStride, size_t count, float* dst, size_t dstStride)
+{
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    for (size_t i = 0; i < count; i++) {
+        memcpy(out, src, N * sizeof(float));
+
+        src += srcStride;
+        out += dstStride;
+    }
+}
+
+template<uint32_t N>
+static void DecodeComponents(const cgltf_accessor* accessor, const uint8_t* src, size_t count, float* dst, size_t dstStride)
+{
+    size_t stride = accessor->stride;
+    bool normalized = accessor->normalized;
+
+    switch (accessor->component_type) {
+        case cgltf_component_type_r_32f:
+            DecodeStridedFloat<N>(src, stride, count, dst, dstStride);
+            break;
+        case cgltf_component_type_r_8:
+            DecodeStrided<int8_t, N>(src, stride, count, normalized, dst, dstStride);
+            break;
+        case cgltf_component_type_r_8u:
+            DecodeStrided<uint8_t, N>(src, stride, count, normalized, dst, dstStride);
+            break;
+        case cgltf_component_type_r_16:
+            DecodeStrided<int16_t, N>(src, stride, count, normalized, dst, dstStride);
+            break;
+        case cgltf_component_type_r_16u:
+            DecodeStrided<uint16_t, N>(src, stride, count, normalized, dst, dstStride);
+            break;
+        case cgltf_component_type_r_32u:
+            DecodeStrided<uint32_t, N>(src, stride, count, false, dst, dstStride);
+            break;
+        default:
+            break;
+    }
+}
+
+static void DecodeFloatsFallback(const cgltf_accessor* accessor, size_t count, float* dst, size_t dstStride, uint32_t components)
+{
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    for (size_t i = 0; i < count; i++) {
+        float values[16] = {};
+        if (cgltf_accessor_read_float(accessor, i, values, 16)) {
+            memcpy(out, values, components * sizeof(float));
+        }
+        out += dstStride;
+    }
+}
+
+void AccessorDecoder::DecodeFloats(const cgltf_accessor* accessor, float* dst, size_t dstCount, size_t dstStride, uint32_t components)
+{
+    uint32_t accessorComponents = static_cast<uint32_t>(cgltf_num_components(accessor->type));
+    uint32_t n = std::min(components, accessorComponents);
+    size_t count = std::min(accessor->count, dstCount);
+
+    const uint8_t* src = accessor->buffer_view ? cgltf_buffer_view_data(accessor->buffer_view) : nullptr;
+
+    // Sparse, matrix (column padding) or bufferless accessors: let cgltf deal with them
+    if (!src || accessor->is_sparse || accessor->type > cgltf_type_vec4) {
+        DecodeFloatsFallback(accessor, count, dst, dstStride, n);
+        return;
+    }
+    src += accessor->offset;
+
+    switch (n) {
+        case 1: DecodeComponents<1>(accessor, src, count, dst, dstStride); break;
+        case 2: DecodeComponents<2>(accessor, src, count, dst, dstStride); break;
+        case 3: DecodeComponents<3>(accessor, src, count, dst, dstStride); break;
+        case 4: DecodeComponents<4>(accessor, src, count, dst, dstStride); break;
+        default: break;
+    }
+}
+
+template<typename T>
+static void DecodeIndicesStrided(const uint8_t* src, size_t stride, size_t count, uint32_t* dst)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = ReadUnaligned<T>(src + i * stride);
+    }
+}
+
+static void DecodeIndices16(const uint8_t* src, size_t count, uint32_t* dst)
+{
+    size_t i = 0;
+#ifdef ACCESSOR_DECODER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(uint16_t)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(packed, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(packed, zero));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = ReadUnaligned<uint16_t>(src + i * sizeof(uint16_t));
+    }
+}
+
+static void DecodeIndices8(const uint8_t* src, size_t count, uint32_t* dst)
+{
+    size_t i = 0;
+#ifdef ACCESSOR_DECODER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i low = _mm_unpacklo_epi8(packed, zero);
+        __m128i high = _mm_unpackhi_epi8(packed, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(high, zero));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i];
+    }
+}
+
+void AccessorDecoder::DecodeIndices(const cgltf_accessor* accessor, uint32_t* dst)
+{
+    const uint8_t* src = accessor->buffer_view ? cgltf_buffer_view_data(accessor->buffer_view) : nullptr;
+    if (!src || accessor->is_sparse) {
+        for (size_t i = 0; i < accessor->count; i++) {
+            dst[i] = static_cast<uint32_t>(cgltf_accessor_read_index(accessor, i));
+        }
+        return;
+    }
+    src += accessor->offset;
+
+    size_t count = accessor->count;
+    size_t stride = accessor->stride;
+    switch (accessor->component_type) {
+        case cgltf_component_type_r_8u:
+            if (stride == sizeof(uint8_t)) {
+                DecodeIndices8(src, count, dst);
+            } else {
+                DecodeIndicesStrided<uint8_t>(src, stride, count, dst);
+            }
+            break;
+        case cgltf_component_type_r_16u:
+            if (stride == sizeof(uint16_t)) {
+                DecodeIndices16(src, count, dst);
+            } else {
+                DecodeIndicesStrided<uint16_t>(src, stride, count, dst);
+            }
+            break;
+        case cgltf_component_type_r_32u:
+            if (stride == sizeof(uint32_t)) {
+                memcpy(dst, src, count * sizeof(uint32_t));
+            } else {
+                DecodeIndicesStrided<uint32_t>(src, stride, count, dst);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = static_cast<uint32_t>(cgltf_accessor_read_index(accessor, i));
+            }
+            break;
+    }
+}
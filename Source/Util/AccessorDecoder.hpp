@@ -0,0 +1,27 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-12 15:41:08
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <cgltf.h>
+
+/*
+    Bulk accessor decoding. Replaces per element cgltf_accessor_read_float/cgltf_accessor_read_index calls with one tight strided loop per accessor.
+    Conversions match cgltf's (same divisions for normalized types) so the output is identical to the per element path.
+    8/16 bit components (KHR_mesh_quantization) are widened straight into the destination floats, 4 components per SSE2 load.
+*/
+
+class AccessorDecoder
+{
+public:
+    /// @note(ame): writes min(components, accessor components) floats per element to dst, advancing dstStride bytes per element.
+    /// Decodes min(accessor->count, dstCount) elements, components and elements the accessor doesn't have are left untouched.
+    static void DecodeFloats(const cgltf_accessor* accessor, float* dst, size_t dstCount, size_t dstStride, uint32_t components);
+
+    /// @note(ame): dst must hold accessor->count indices.
+    static void DecodeIndices(const cgltf_accessor* accessor, uint32_t* dst);
+};
@@ -0,0 +1,549 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-24 10:31:48
+//
+
+#include "BlockCompression.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+/// @note(ame): block rows per job when compressing a level, levels with fewer rows than this are done on the calling thread.
+#define BLOCK_ROWS_PER_JOB 4
+
+/// @note(ame): BC7 4 bit index weights, out of 64.
+static const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/// @note(ame): little endian bit writer for one 128 bit block.
+struct BlockBits
+{
+    uint64_t Words[2] = {};
+    uint32_t Position = 0;
+
+    void Write(uint32_t value, uint32_t bits)
+    {
+        for (uint32_t i = 0; i < bits; i++, Position++) {
+            Words[Position / 64] |= static_cast<uint64_t>((value >> i) & 1) << (Position % 64);
+        }
+    }
+};
+
+static void StoreLE(uint64_t value, uint8_t* out)
+{
+    for (uint32_t i = 0; i < 8; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+/// @note(ame): dominant eigenvector of the covariance of the first channels components, power iteration.
+static glm::vec4 PrincipalAxis(const glm::vec4* texels, const bool* used, glm::vec4 mean, uint32_t channels)
+{
+    glm::mat4 covariance(0.0f);
+    for (uint32_t i = 0; i < 16; i++) {
+        if (!used[i]) {
+            continue;
+        }
+        glm::vec4 delta = texels[i] - mean;
+        if (channels == 3) {
+            delta.w = 0.0f;
+        }
+        covariance += glm::outerProduct(delta, delta);
+    }
+
+    // Start from the column with the most variance, it can't be orthogonal to the answer
+    uint32_t start = 0;
+    for (uint32_t c = 1; c < channels; c++) {
+        if (covariance[c][c] > covariance[start][start]) {
+            start = c;
+        }
+    }
+
+    glm::vec4 axis = covariance[start];
+    for (uint32_t i = 0; i < 8; i++) {
+        float scale = std::max({ std::abs(axis.x), std::abs(axis.y), std::abs(axis.z), std::abs(axis.w) });
+        if (scale < 1e-12f) {
+            break;
+        }
+        axis = covariance * (axis / scale);
+    }
+
+    float length = glm::length(axis);
+    if (length < 1e-12f) {
+        return channels == 3 ? glm::vec4(0.57735f, 0.57735f, 0.57735f, 0.0f) : glm::vec4(0.5f);
+    }
+    return axis / length;
+}
+
+/// @note(ame): endpoints over the used texels projected on the principal axis.
+static void AxisEndpoints(const glm::vec4* texels, const bool* used, uint32_t channels, glm::vec4& start, glm::vec4& end)
+{
+    glm::vec4 mean(0.0f);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        if (used[i]) {
+            mean += texels[i];
+            count++;
+        }
+    }
+    mean /= static_cast<float>(std::max(count, 1u));
+
+    glm::vec4 axis = PrincipalAxis(texels, used, mean, channels);
+    float minimum = FLT_MAX;
+    float maximum = -FLT_MAX;
+    for (uint32_t i = 0; i < 16; i++) {
+        if (used[i]) {
+            float t = glm::dot(texels[i] - mean, axis);
+            minimum = std::min(minimum, t);
+            maximum = std::max(maximum, t);
+        }
+    }
+    start = glm::clamp(mean + axis * minimum, 0.0f, 255.0f);
+    end = glm::clamp(mean + axis * maximum, 0.0f, 255.0f);
+}
+
+/// @note(ame): least squares endpoints for fixed interpolation weights (0 = start, 1 = end). False if the system is singular.
+static bool RefitEndpoints(const glm::vec4* texels, const bool* used, const float* weights, glm::vec4& start, glm::vec4& end)
+{
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    glm::vec4 ax(0.0f), bx(0.0f);
+    for (uint32_t i = 0; i < 16; i++) {
+        if (!used[i]) {
+            continue;
+        }
+        float b = weights[i];
+        float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        ax += a * texels[i];
+        bx += b * texels[i];
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) {
+        return false;
+    }
+    start = glm::clamp((ax * bb - bx * ab) / determinant, 0.0f, 255.0f);
+    end = glm::clamp((bx * aa - ax * ab) / determinant, 0.0f, 255.0f);
+    return true;
+}
+
+static float SquaredError(glm::vec4 a, glm::vec4 b)
+{
+    glm::vec4 delta = a - b;
+    return glm::dot(delta, delta);
+}
+
+//
+// BC1
+//
+
+static uint16_t PackRGB565(glm::vec4 color)
+{
+    uint32_t r = static_cast<uint32_t>(color.r * 31.0f / 255.0f + 0.5f);
+    uint32_t g = static_cast<uint32_t>(color.g * 63.0f / 255.0f + 0.5f);
+    uint32_t b = static_cast<uint32_t>(color.b * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>((std::min(r, 31u) << 11) | (std::min(g, 63u) << 5) | std::min(b, 31u));
+}
+
+static glm::vec4 UnpackRGB565(uint16_t color)
+{
+    uint32_t r = (color >> 11) & 31;
+    uint32_t g = (color >> 5) & 63;
+    uint32_t b = color & 31;
+    return glm::vec4((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 0.0f);
+}
+
+/// @note(ame): palette and per index weights for c0/c1, in the mode the decoder will pick from their order.
+static uint32_t BC1Palette(uint16_t c0, uint16_t c1, bool punchThrough, glm::vec4* palette, float* weights)
+{
+    glm::vec4 a = UnpackRGB565(c0);
+    glm::vec4 b = UnpackRGB565(c1);
+    palette[0] = a;
+    palette[1] = b;
+    weights[0] = 0.0f;
+    weights[1] = 1.0f;
+    if (!punchThrough) {
+        palette[2] = glm::floor((2.0f * a + b + 1.0f) / 3.0f);
+        palette[3] = glm::floor((a + 2.0f * b + 1.0f) / 3.0f);
+        weights[2] = 1.0f / 3.0f;
+        weights[3] = 2.0f / 3.0f;
+        return 4;
+    }
+    palette[2] = glm::floor((a + b + 1.0f) / 2.0f);
+    weights[2] = 0.5f;
+    return 3;
+}
+
+static void CompressBC1(const uint8_t* texels, uint8_t* out)
+{
+    glm::vec4 colors[16];
+    bool used[16];
+    bool punchThrough = false;
+    uint32_t usedCount = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        colors[i] = glm::vec4(texels[i * 4 + 0], texels[i * 4 + 1], texels[i * 4 + 2], 0.0f);
+        used[i] = texels[i * 4 + 3] >= 128;
+        punchThrough |= !used[i];
+        usedCount += used[i];
+    }
+
+    uint16_t best0 = 0;
+    uint16_t best1 = 0;
+    uint32_t bestIndices[16] = {};
+    if (usedCount == 0) {
+        // Fully transparent, 3 color mode with every texel on index 3
+        std::fill(bestIndices, bestIndices + 16, 3u);
+    } else {
+        glm::vec4 start, end;
+        AxisEndpoints(colors, used, 3, start, end);
+
+        float bestError = FLT_MAX;
+        for (uint32_t iteration = 0; iteration < 2; iteration++) {
+            uint16_t c0 = PackRGB565(start);
+            uint16_t c1 = PackRGB565(end);
+
+            glm::vec4 palette[4];
+            float paletteWeights[4];
+            uint32_t paletteSize = BC1Palette(c0, c1, punchThrough, palette, paletteWeights);
+
+            uint32_t indices[16];
+            float weights[16];
+            float error = 0.0f;
+            for (uint32_t i = 0; i < 16; i++) {
+                if (!used[i]) {
+                    indices[i] = 3;
+                    weights[i] = 0.0f;
+                    continue;
+                }
+                uint32_t nearest = 0;
+                float nearestError = FLT_MAX;
+                for (uint32_t p = 0; p < paletteSize; p++) {
+                    float e = SquaredError(colors[i], palette[p]);
+                    if (e < nearestError) {
+                        nearest = p;
+                        nearestError = e;
+                    }
+                }
+                indices[i] = nearest;
+                weights[i] = paletteWeights[nearest];
+                error += nearestError;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                best0 = c0;
+                best1 = c1;
+                std::copy(indices, indices + 16, bestIndices);
+            }
+            if (!RefitEndpoints(colors, used, weights, start, end)) {
+                break;
+            }
+        }
+
+        // The endpoint order selects the mode: c0 > c1 is 4 colors, c0 <= c1 is 3 colors + transparent
+        if (!punchThrough && best0 < best1) {
+            std::swap(best0, best1);
+            // 0 <-> 1 and 2 <-> 3
+            for (uint32_t& index : bestIndices) {
+                index ^= 1;
+            }
+        } else if (!punchThrough && best0 == best1) {
+            std::fill(bestIndices, bestIndices + 16, 0u);
+        } else if (punchThrough && best0 > best1) {
+            std::swap(best0, best1);
+            for (uint32_t& index : bestIndices) {
+                if (index < 2) {
+                    index ^= 1;
+                }
+            }
+        }
+    }
+
+    uint32_t indexBits = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        indexBits |= bestIndices[i] << (i * 2);
+    }
+    out[0] = static_cast<uint8_t>(best0);
+    out[1] = static_cast<uint8_t>(best0 >> 8);
+    out[2] = static_cast<uint8_t>(best1);
+    out[3] = static_cast<uint8_t>(best1 >> 8);
+    for (uint32_t i = 0; i < 4; i++) {
+        out[4 + i] = static_cast<uint8_t>(indexBits >> (i * 8));
+    }
+}
+
+//
+// BC4
+//
+
+static void BC4Palette(uint32_t a0, uint32_t a1, uint32_t* palette)
+{
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (uint32_t i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+        }
+    } else {
+        for (uint32_t i = 2; i < 6; i++) {
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+static uint32_t BC4Indices(const uint32_t* values, uint32_t a0, uint32_t a1, uint64_t& indexBits)
+{
+    uint32_t palette[8];
+    BC4Palette(a0, a1, palette);
+
+    uint32_t error = 0;
+    indexBits = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t nearest = 0;
+        uint32_t nearestError = UINT32_MAX;
+        for (uint32_t p = 0; p < 8; p++) {
+            int delta = static_cast<int>(values[i]) - static_cast<int>(palette[p]);
+            uint32_t e = static_cast<uint32_t>(delta * delta);
+            if (e < nearestError) {
+                nearest = p;
+                nearestError = e;
+            }
+        }
+        indexBits |= static_cast<uint64_t>(nearest) << (i * 3);
+        error += nearestError;
+    }
+    return error;
+}
+
+static void CompressBC4(const uint8_t* texels, uint32_t channel, uint8_t* out)
+{
+    uint32_t values[16];
+    uint32_t minimum = 255, maximum = 0;
+    // The 6 value mode has exact 0 and 255, its endpoints only need to cover the rest
+    uint32_t innerMinimum = 255, innerMaximum = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        values[i] = texels[i * 4 + channel];
+        minimum = std::min(minimum, values[i]);
+        maximum = std::max(maximum, values[i]);
+        if (values[i] != 0 && values[i] != 255) {
+            innerMinimum = std::min(innerMinimum, values[i]);
+            innerMaximum = std::max(innerMaximum, values[i]);
+        }
+    }
+    if (innerMinimum > innerMaximum) {
+        innerMinimum = innerMaximum = 0;
+    }
+
+    uint64_t bits8, bits6;
+    uint32_t error8 = BC4Indices(values, maximum, minimum, bits8);
+    uint32_t error6 = BC4Indices(values, innerMinimum, innerMaximum, bits6);
+
+    bool sixValues = error6 < error8;
+    uint64_t block = sixValues ? innerMinimum | (innerMaximum << 8) | (bits6 << 16) : maximum | (minimum << 8) | (bits8 << 16);
+    StoreLE(block, out);
+}
+
+//
+// BC7 mode 6
+//
+
+/// @note(ame): BC7_WEIGHTS index closest to t * 64, t in [0, 1].
+static uint32_t NearestWeight(float t)
+{
+    static const auto table = [] {
+        std::array<uint8_t, 65> result;
+        for (int w = 0; w <= 64; w++) {
+            uint32_t nearest = 0;
+            for (uint32_t i = 1; i < 16; i++) {
+                if (std::abs(BC7_WEIGHTS[i] - w) < std::abs(BC7_WEIGHTS[nearest] - w)) {
+                    nearest = i;
+                }
+            }
+            result[w] = static_cast<uint8_t>(nearest);
+        }
+        return result;
+    }();
+    return table[static_cast<uint32_t>(std::clamp(t, 0.0f, 1.0f) * 64.0f + 0.5f)];
+}
+
+static void CompressBC7(const uint8_t* texels, uint8_t* out)
+{
+    glm::vec4 colors[16];
+    bool used[16];
+    for (uint32_t i = 0; i < 16; i++) {
+        colors[i] = glm::vec4(texels[i * 4 + 0], texels[i * 4 + 1], texels[i * 4 + 2], texels[i * 4 + 3]);
+        used[i] = true;
+    }
+
+    glm::vec4 axisStart, axisEnd;
+    AxisEndpoints(colors, used, 4, axisStart, axisEnd);
+
+    float bestError = FLT_MAX;
+    glm::ivec4 bestEndpoints[2];
+    uint32_t bestPBits[2] = {};
+    uint32_t bestIndices[16] = {};
+    for (uint32_t pbits = 0; pbits < 4; pbits++) {
+        uint32_t p[2] = { pbits & 1, pbits >> 1 };
+        glm::vec4 start = axisStart;
+        glm::vec4 end = axisEnd;
+
+        for (uint32_t iteration = 0; iteration < 2; iteration++) {
+            // 7 bit endpoints, the p-bit is the low bit of every channel
+            glm::ivec4 quantized[2];
+            glm::ivec4 endpoints[2];
+            const glm::vec4 sources[2] = { start, end };
+            for (uint32_t e = 0; e < 2; e++) {
+                quantized[e] = glm::clamp(glm::ivec4(glm::floor((sources[e] - static_cast<float>(p[e])) / 2.0f + 0.5f)), 0, 127);
+                endpoints[e] = (quantized[e] << 1) | static_cast<int>(p[e]);
+            }
+
+            glm::vec4 palette[16];
+            for (uint32_t i = 0; i < 16; i++) {
+                palette[i] = glm::vec4(((64 - BC7_WEIGHTS[i]) * endpoints[0] + BC7_WEIGHTS[i] * endpoints[1] + 32) >> 6);
+            }
+
+            // Project on the endpoint line for a first guess, then settle between its neighbours
+            glm::vec4 direction = glm::vec4(endpoints[1] - endpoints[0]);
+            float lengthSquared = glm::dot(direction, direction);
+
+            uint32_t indices[16];
+            float weights[16];
+            float error = 0.0f;
+            for (uint32_t i = 0; i < 16; i++) {
+                uint32_t guess = lengthSquared > 0.0f ? NearestWeight(glm::dot(colors[i] - glm::vec4(endpoints[0]), direction) / lengthSquared) : 0;
+                uint32_t nearest = guess;
+                float nearestError = SquaredError(colors[i], palette[guess]);
+                for (uint32_t candidate = guess > 0 ? guess - 1 : 0; candidate <= std::min(guess + 1, 15u); candidate++) {
+                    float e = SquaredError(colors[i], palette[candidate]);
+                    if (e < nearestError) {
+                        nearest = candidate;
+                        nearestError = e;
+                    }
+                }
+                indices[i] = nearest;
+                weights[i] = BC7_WEIGHTS[nearest] / 64.0f;
+                error += nearestError;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                bestEndpoints[0] = quantized[0];
+                bestEndpoints[1] = quantized[1];
+                bestPBits[0] = p[0];
+                bestPBits[1] = p[1];
+                std::copy(indices, indices + 16, bestIndices);
+            }
+            if (error == 0.0f || !RefitEndpoints(colors, used, weights, start, end)) {
+                break;
+            }
+        }
+    }
+
+    // The anchor (texel 0) index has an implicit high bit of 0, flip the block around if it's set
+    if (bestIndices[0] >= 8) {
+        std::swap(bestEndpoints[0], bestEndpoints[1]);
+        std::swap(bestPBits[0], bestPBits[1]);
+        for (uint32_t& index : bestIndices) {
+            index = 15 - index;
+        }
+    }
+
+    BlockBits bits;
+    bits.Write(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; c++) {
+        bits.Write(bestEndpoints[0][c], 7);
+        bits.Write(bestEndpoints[1][c], 7);
+    }
+    bits.Write(bestPBits[0], 1);
+    bits.Write(bestPBits[1], 1);
+    bits.Write(bestIndices[0], 3);
+    for (uint32_t i = 1; i < 16; i++) {
+        bits.Write(bestIndices[i], 4);
+    }
+    StoreLE(bits.Words[0], out);
+    StoreLE(bits.Words[1], out + 8);
+}
+
+uint32_t BlockBytes(BlockFormat format)
+{
+    return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+}
+
+size_t BlockCompressedSize(uint32_t width, uint32_t height, BlockFormat format)
+{
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+}
+
+void CompressBlock(const uint8_t* texels, BlockFormat format, uint8_t* out)
+{
+    switch (format) {
+        case BlockFormat::BC1:
+            CompressBC1(texels, out);
+            break;
+        case BlockFormat::BC4:
+            CompressBC4(texels, 0, out);
+            break;
+        case BlockFormat::BC5:
+            CompressBC4(texels, 0, out);
+            CompressBC4(texels, 1, out + 8);
+            break;
+        case BlockFormat::BC7:
+            CompressBC7(texels, out);
+            break;
+    }
+}
+
+static void CompressBlockRows(const uint8_t* level, uint32_t width, uint32_t height, BlockFormat format, uint8_t* out, uint32_t rowBegin, uint32_t rowEnd)
+{
+    uint32_t blocksWide = (width + 3) / 4;
+    uint32_t blockBytes = BlockBytes(format);
+
+    uint8_t texels[64];
+    for (uint32_t by = rowBegin; by < rowEnd; by++) {
+        for (uint32_t bx = 0; bx < blocksWide; bx++) {
+            // Partial blocks repeat the last row/column, it keeps the endpoints on the real texels
+            for (uint32_t y = 0; y < 4; y++) {
+                uint32_t sy = std::min(by * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; x++) {
+                    uint32_t sx = std::min(bx * 4 + x, width - 1);
+                    std::copy_n(level + (static_cast<size_t>(sy) * width + sx) * 4, 4, texels + (y * 4 + x) * 4);
+                }
+            }
+            CompressBlock(texels, format, out + (static_cast<size_t>(by) * blocksWide + bx) * blockBytes);
+        }
+    }
+}
+
+void CompressMipChain(const uint8_t* chain, uint32_t width, uint32_t height, uint32_t levels, BlockFormat format, std::vector<uint8_t>& out, bool parallel)
+{
+    size_t size = 0;
+    for (uint32_t level = 0, w = width, h = height; level < levels; level++, w = std::max(w / 2, 1u), h = std::max(h / 2, 1u)) {
+        size += BlockCompressedSize(w, h, format);
+    }
+    out.resize(size);
+
+    const uint8_t* source = chain;
+    uint8_t* destination = out.data();
+    for (uint32_t level = 0; level < levels; level++) {
+        uint32_t blocksHigh = (height + 3) / 4;
+        if (parallel && blocksHigh > BLOCK_ROWS_PER_JOB) {
+            uint32_t chunks = (blocksHigh + BLOCK_ROWS_PER_JOB - 1) / BLOCK_ROWS_PER_JOB;
+            JobSystem::ParallelFor(chunks, [&](uint32_t chunk) {
+                CompressBlockRows(source, width, height, format, destination, chunk * BLOCK_ROWS_PER_JOB, std::min(blocksHigh, (chunk + 1) * BLOCK_ROWS_PER_JOB));
+            });
+        } else {
+            CompressBlockRows(source, width, height, format, destination, 0, blocksHigh);
+        }
+
+        source += static_cast<size_t>(width) * height * 4;
+        destination += BlockCompressedSize(width, height, format);
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+}
@@ -0,0 +1,40 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-24 10:05:31
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <vector>
+
+/*
+    CPU block compression of RGBA8 texels, one 4x4 block at a time:
+        - BC1: RGB 565 endpoints along the principal axis, least squares refit. Blocks with alpha < 128 use the 3 color mode with punch-through alpha.
+        - BC4: one channel, both the 8 value and the 6 value (+ exact 0/255) modes are tried.
+        - BC5: BC4 on R then G.
+        - BC7: mode 6 only (one subset, RGBA 7.7.7.7 + p-bits, 4 bit indices), principal axis endpoints, least squares refit per p-bit pair.
+    Mode 6 covers everything with the same code path, the multi subset modes would buy quality on sharp color edges for a lot more search.
+    Edge blocks of levels that aren't a multiple of 4 repeat their last row/column.
+*/
+
+enum class BlockFormat : uint32_t
+{
+    BC1,
+    BC4,
+    BC5,
+    BC7
+};
+
+/// @note(ame): 8 for BC1/BC4, 16 for BC5/BC7.
+uint32_t BlockBytes(BlockFormat format);
+/// @note(ame): bytes of one level, partial blocks count as whole ones.
+size_t BlockCompressedSize(uint32_t width, uint32_t height, BlockFormat format);
+
+/// @note(ame): texels is a 4x4 block, row major RGBA8. BC4 only reads R, BC5 R and G.
+void CompressBlock(const uint8_t* texels, BlockFormat format, uint8_t* out);
+
+/// @note(ame): compresses a tightly packed RGBA8 chain (see Util/MipGenerator.hpp) into tightly packed levels of blocks.
+/// Block rows are split across the job system when parallel is set, safe to call from inside a job.
+void CompressMipChain(const uint8_t* chain, uint32_t width, uint32_t height, uint32_t levels, BlockFormat format, std::vector<uint8_t>& out, bool parallel = true);
@@ -0,0 +1,231 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-16 15:21:13
+//
+
+#include "ClusterBuilder.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+void ClusterBuilder::Build(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, ClusterData& out)
+{
+    out = {};
+
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    // Fixed chunk boundaries keep the output identical whatever the worker count
+    uint32_t chunkCount = static_cast<uint32_t>((triangleCount + CLUSTER_CHUNK_TRIANGLES - 1) / CLUSTER_CHUNK_TRIANGLES);
+    std::vector<ClusterData> chunks(chunkCount);
+    JobSystem::ParallelFor(chunkCount, [&](uint32_t i) {
+        size_t first = static_cast<size_t>(i) * CLUSTER_CHUNK_TRIANGLES;
+        size_t count = std::min(static_cast<size_t>(CLUSTER_CHUNK_TRIANGLES), triangleCount - first);
+        BuildChunk(indices + first * 3, count, chunks[i]);
+    });
+
+    size_t clusterCount = 0;
+    size_t localVertexCount = 0;
+    size_t localTriangleCount = 0;
+    for (auto& chunk : chunks) {
+        clusterCount += chunk.Clusters.size();
+        localVertexCount += chunk.Vertices.size();
+        localTriangleCount += chunk.Triangles.size();
+    }
+    out.Clusters.reserve(clusterCount);
+    out.Vertices.reserve(localVertexCount);
+    out.Triangles.reserve(localTriangleCount);
+
+    for (auto& chunk : chunks) {
+        uint32_t vertexBase = static_cast<uint32_t>(out.Vertices.size());
+        uint32_t triangleBase = static_cast<uint32_t>(out.Triangles.size());
+        for (Cluster cluster : chunk.Clusters) {
+            cluster.VertexOffset += vertexBase;
+            cluster.TriangleOffset += triangleBase;
+            out.Clusters.push_back(cluster);
+        }
+        out.Vertices.insert(out.Vertices.end(), chunk.Vertices.begin(), chunk.Vertices.end());
+        out.Triangles.insert(out.Triangles.end(), chunk.Triangles.begin(), chunk.Triangles.end());
+    }
+
+    JobSystem::ParallelFor(static_cast<uint32_t>(out.Clusters.size()), [&](uint32_t i) {
+        ComputeBounds(vertices, out, out.Clusters[i]);
+    });
+}
+
+void ClusterBuilder::BuildChunk(const uint32_t* indices, size_t triangleCount, ClusterData& out)
+{
+    Cluster current = {};
+    auto flush = [&]() {
+        if (current.TriangleCount > 0) {
+            out.Clusters.push_back(current);
+        }
+        current = {};
+        current.VertexOffset = static_cast<uint32_t>(out.Vertices.size());
+        current.TriangleOffset = static_cast<uint32_t>(out.Triangles.size());
+    };
+    flush();
+
+    // Linear search is fine, a cluster never holds more than CLUSTER_MAX_VERTICES vertices
+    auto findLocal = [&](uint32_t index) -> int {
+        const uint32_t* local = out.Vertices.data() + current.VertexOffset;
+        for (uint32_t i = 0; i < current.VertexCount; i++) {
+            if (local[i] == index) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    };
+
+    for (size_t t = 0; t < triangleCount; t++) {
+        uint32_t triangle[3] = { indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2] };
+
+        int local[3];
+        uint32_t newVertices = 0;
+        for (int k = 0; k < 3; k++) {
+            local[k] = findLocal(triangle[k]);
+            if (local[k] < 0 && (k < 1 || triangle[k] != triangle[0]) && (k < 2 || triangle[k] != triangle[1])) {
+                newVertices++;
+            }
+        }
+
+        if (current.VertexCount + newVertices > CLUSTER_MAX_VERTICES || current.TriangleCount + 1 > CLUSTER_MAX_TRIANGLES) {
+            flush();
+            for (int k = 0; k < 3; k++) {
+                local[k] = -1;
+            }
+        }
+
+        for (int k = 0; k < 3; k++) {
+            if (local[k] < 0) {
+                local[k] = findLocal(triangle[k]);
+            }
+            if (local[k] < 0) {
+                local[k] = static_cast<int>(current.VertexCount++);
+                out.Vertices.push_back(triangle[k]);
+            }
+            out.Triangles.push_back(static_cast<uint8_t>(local[k]));
+        }
+        current.TriangleCount++;
+    }
+    flush();
+}
+
+void ClusterBuilder::ComputeBounds(const Vertex* vertices, const ClusterData& data, Cluster& cluster)
+{
+    const uint32_t* local = data.Vertices.data() + cluster.VertexOffset;
+    const uint8_t* triangles = data.Triangles.data() + cluster.TriangleOffset;
+
+    cluster.BoundsMin = glm::vec3(FLT_MAX);
+    cluster.BoundsMax = glm::vec3(-FLT_MAX);
+    for (uint32_t i = 0; i < cluster.VertexCount; i++) {
+        cluster.BoundsMin = glm::min(cluster.BoundsMin, vertices[local[i]].Position);
+        cluster.BoundsMax = glm::max(cluster.BoundsMax, vertices[local[i]].Position);
+    }
+
+    cluster.Center = (cluster.BoundsMin + cluster.BoundsMax) * 0.5f;
+    cluster.Radius = 0.0f;
+    for (uint32_t i = 0; i < cluster.VertexCount; i++) {
+        cluster.Radius = std::max(cluster.Radius, glm::length(vertices[local[i]].Position - cluster.Center));
+    }
+
+    // Normal cone from the face normals, weighted by area through the unnormalized cross product
+    std::array<glm::vec3, CLUSTER_MAX_TRIANGLES> normals;
+    glm::vec3 axis(0.0f);
+    uint32_t validNormals = 0;
+    for (uint32_t i = 0; i < cluster.TriangleCount; i++) {
+        glm::vec3 p0 = vertices[local[triangles[i * 3 + 0]]].Position;
+        glm::vec3 p1 = vertices[local[triangles[i * 3 + 1]]].Position;
+        glm::vec3 p2 = vertices[local[triangles[i * 3 + 2]]].Position;
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float area = glm::length(normal);
+        normals[i] = area > 0.0f ? normal / area : glm::vec3(0.0f);
+        if (area > 0.0f) {
+            axis += normal;
+            validNormals++;
+        }
+    }
+
+    cluster.ConeApex = cluster.Center;
+    cluster.ConeAxis = glm::vec3(0.0f);
+    cluster.ConeCutoff = 1.0f;
+
+    float axisLength = glm::length(axis);
+    if (validNormals == 0 || axisLength <= 0.0f) {
+        return;
+    }
+    axis /= axisLength;
+
+    float minDot = 1.0f;
+    for (uint32_t i = 0; i < cluster.TriangleCount; i++) {
+        if (normals[i] != glm::vec3(0.0f)) {
+            minDot = std::min(minDot, glm::dot(normals[i], axis));
+        }
+    }
+
+    // Past ~85 degrees of spread the cone test culls next to nothing, don't pretend otherwise
+    if (minDot <= 0.1f) {
+        return;
+    }
+
+    // Move the apex back along the axis until every triangle plane is in front of it
+    float maxT = 0.0f;
+    for (uint32_t i = 0; i < cluster.TriangleCount; i++) {
+        if (normals[i] == glm::vec3(0.0f)) {
+            continue;
+        }
+        glm::vec3 p0 = vertices[local[triangles[i * 3 + 0]]].Position;
+        float t = glm::dot(cluster.Center - p0, normals[i]) / glm::dot(axis, normals[i]);
+        maxT = std::max(maxT, t);
+    }
+
+    cluster.ConeApex = cluster.Center - axis * maxT;
+    cluster.ConeAxis = axis;
+    cluster.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+bool ClusterBuilder::Validate(const ClusterData& data, const uint32_t* indices, size_t indexCount)
+{
+    using Triangle = std::array<uint32_t, 3>;
+
+    std::vector<Triangle> expected(indexCount / 3);
+    for (size_t i = 0; i < expected.size(); i++) {
+        expected[i] = { indices[i * 3 + 0], indices[i * 3 + 1], indices[i * 3 + 2] };
+    }
+
+    std::vector<Triangle> covered;
+    covered.reserve(expected.size());
+    for (const Cluster& cluster : data.Clusters) {
+        if (cluster.VertexCount > CLUSTER_MAX_VERTICES || cluster.TriangleCount > CLUSTER_MAX_TRIANGLES) {
+            return false;
+        }
+        if (cluster.VertexOffset + cluster.VertexCount > data.Vertices.size() || cluster.TriangleOffset + cluster.TriangleCount * 3 > data.Triangles.size()) {
+            return false;
+        }
+
+        const uint32_t* local = data.Vertices.data() + cluster.VertexOffset;
+        const uint8_t* triangles = data.Triangles.data() + cluster.TriangleOffset;
+        for (uint32_t i = 0; i < cluster.TriangleCount; i++) {
+            Triangle triangle;
+            for (int k = 0; k < 3; k++) {
+                uint8_t index = triangles[i * 3 + k];
+                if (index >= cluster.VertexCount) {
+                    return false;
+                }
+                triangle[k] = local[index];
+            }
+            covered.push_back(triangle);
+        }
+    }
+
+    // Same multiset of triangles, winding included
+    std::sort(expected.begin(), expected.end());
+    std::sort(covered.begin(), covered.end());
+    return expected == covered;
+}
@@ -0,0 +1,59 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-16 15:08:40
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "TangentCalculator.hpp"
+
+/*
+    Splits a primitive into bounded triangle clusters (meshlets), each with an AABB, a bounding sphere and a normal cone.
+    Triangles are scanned in index order, so run it on locality optimized indices (MeshLocality) to get compact clusters.
+    Building is chunked: every CLUSTER_CHUNK_TRIANGLES triangles are clustered independently on the job system and
+    concatenated in chunk order, so the result does not depend on the thread count.
+*/
+
+#define CLUSTER_MAX_VERTICES 64
+#define CLUSTER_MAX_TRIANGLES 124
+#define CLUSTER_CHUNK_TRIANGLES 16384
+
+struct Cluster
+{
+    uint32_t VertexOffset;   // into ClusterData::Vertices
+    uint32_t TriangleOffset; // into ClusterData::Triangles, 3 local indices per triangle
+    uint32_t VertexCount;
+    uint32_t TriangleCount;
+
+    glm::vec3 BoundsMin;
+    glm::vec3 BoundsMax;
+    glm::vec3 Center;
+    float Radius;
+
+    /// @note(ame): the cluster is entirely backfacing from eye if dot(normalize(ConeApex - eye), ConeAxis) >= ConeCutoff.
+    /// ConeCutoff is 1 when the normals are too spread out for the test to ever pass.
+    glm::vec3 ConeApex;
+    glm::vec3 ConeAxis;
+    float ConeCutoff;
+};
+
+struct ClusterData
+{
+    std::vector<Cluster> Clusters;
+    std::vector<uint32_t> Vertices;
+    std::vector<uint8_t> Triangles;
+};
+
+class ClusterBuilder
+{
+public:
+    static void Build(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, ClusterData& out);
+
+    /// @note(ame): true if every triangle of indices appears exactly once across all clusters and every cluster respects the limits.
+    static bool Validate(const ClusterData& data, const uint32_t* indices, size_t indexCount);
+private:
+    static void BuildChunk(const uint32_t* indices, size_t triangleCount, ClusterData& out);
+    static void ComputeBounds(const Vertex* vertices, const ClusterData& data, Cluster& cluster);
+};
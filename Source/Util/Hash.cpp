@@ -0,0 +1,101 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-13 11:41:16
+//
+
+#include "Hash.hpp"
+
+#include <cstring>
+
+static constexpr uint64_t PRIME_1 = 11400714785074694791ull;
+static constexpr uint64_t PRIME_2 = 14029467366897019727ull;
+static constexpr uint64_t PRIME_3 = 1609587929392839161ull;
+static constexpr uint64_t PRIME_4 = 9650029242287828579ull;
+static constexpr uint64_t PRIME_5 = 2870177450012600261ull;
+
+static inline uint64_t Rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t Read64(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t Read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t Round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME_2;
+    acc = Rotl(acc, 31);
+    return acc * PRIME_1;
+}
+
+static inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+{
+    acc ^= Round(0, value);
+    return acc * PRIME_1 + PRIME_4;
+}
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME_1 + PRIME_2;
+        uint64_t v2 = seed + PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME_1;
+
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = Round(v1, Read64(p)); p += 8;
+            v2 = Round(v2, Read64(p)); p += 8;
+            v3 = Round(v3, Read64(p)); p += 8;
+            v4 = Round(v4, Read64(p)); p += 8;
+        } while (p <= limit);
+
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = MergeRound(h, v1);
+        h = MergeRound(h, v2);
+        h = MergeRound(h, v3);
+        h = MergeRound(h, v4);
+    } else {
+        h = seed + PRIME_5;
+    }
+
+    h += static_cast<uint64_t>(size);
+
+    while (p + 8 <= end) {
+        h ^= Round(0, Read64(p));
+        h = Rotl(h, 27) * PRIME_1 + PRIME_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(Read32(p)) * PRIME_1;
+        h = Rotl(h, 23) * PRIME_2 + PRIME_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME_5;
+        h = Rotl(h, 11) * PRIME_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME_2;
+    h ^= h >> 29;
+    h *= PRIME_3;
+    h ^= h >> 32;
+    return h;
+}
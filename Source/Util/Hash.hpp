@@ -0,0 +1,16 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-13 11:37:50
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+/// @note(ame): XXH64, used to key on-disk caches by file contents. Not a cryptographic hash.
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+
+inline uint64_t HashCombine(uint64_t a, uint64_t b)
+{
+    return a ^ (b + 0x9E3779B97F4A7C15ull + (a << 6) + (a >> 2));
+}
@@ -0,0 +1,88 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-22 10:21:06
+//
+
+#include "ImageInfo.hpp"
+
+#include <cstring>
+#include <fstream>
+
+static uint32_t ReadBE16(const uint8_t* data)
+{
+    return (uint32_t(data[0]) << 8) | data[1];
+}
+
+static uint32_t ReadBE32(const uint8_t* data)
+{
+    return (ReadBE16(data) << 16) | ReadBE16(data + 2);
+}
+
+static bool ReadJPEGSize(std::ifstream& file, uint32_t& width, uint32_t& height)
+{
+    // Walk the segments after SOI until the first frame header
+    file.seekg(2);
+
+    uint8_t marker[2];
+    while (file.read(reinterpret_cast<char*>(marker), 2)) {
+        if (marker[0] != 0xFF) {
+            return false;
+        }
+
+        uint8_t type = marker[1];
+        if (type == 0xFF) {
+            // Fill byte, the marker starts at the next one
+            file.seekg(-1, std::ios::cur);
+            continue;
+        }
+        if (type == 0x01 || (type >= 0xD0 && type <= 0xD8)) {
+            continue;
+        }
+        if (type == 0xD9 || type == 0xDA) {
+            // EOI or scan data before any frame header
+            return false;
+        }
+
+        uint8_t length[2];
+        if (!file.read(reinterpret_cast<char*>(length), 2) || ReadBE16(length) < 2) {
+            return false;
+        }
+
+        // SOF0..SOF15, minus DHT/JPG/DAC which share the range
+        if (type >= 0xC0 && type <= 0xCF && type != 0xC4 && type != 0xC8 && type != 0xCC) {
+            uint8_t frame[5];
+            if (!file.read(reinterpret_cast<char*>(frame), sizeof(frame))) {
+                return false;
+            }
+            height = ReadBE16(frame + 1);
+            width = ReadBE16(frame + 3);
+            return width && height;
+        }
+        file.seekg(ReadBE16(length) - 2, std::ios::cur);
+    }
+    return false;
+}
+
+bool ReadImageSize(const std::string& path, uint32_t& width, uint32_t& height)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    uint8_t header[24] = {};
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    size_t read = file.gcount();
+    file.clear();
+
+    static const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    if (read == sizeof(header) && memcmp(header, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) == 0 && memcmp(header + 12, "IHDR", 4) == 0) {
+        width = ReadBE32(header + 16);
+        height = ReadBE32(header + 20);
+        return width && height;
+    }
+    if (read >= 2 && header[0] == 0xFF && header[1] == 0xD8) {
+        return ReadJPEGSize(file, width, height);
+    }
+    return false;
+}
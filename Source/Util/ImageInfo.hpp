@@ -0,0 +1,12 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-22 10:14:39
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+/// @note(ame): reads the dimensions out of a PNG (IHDR) or JPEG (SOFn) header without decoding anything.
+/// Returns false for other formats or malformed files.
+bool ReadImageSize(const std::string& path, uint32_t& width, uint32_t& height);
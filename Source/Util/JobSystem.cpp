@@ -0,0 +1,125 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-12 10:09:41
+//
+
+#include "JobSystem.hpp"
+
+JobSystem::Data JobSystem::sData;
+
+void JobSystem::Init(uint32_t threadCount)
+{
+    if (threadCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    sData.Running = true;
+    for (uint32_t i = 0; i < threadCount; i++) {
+        sData.Workers.emplace_back(WorkerLoop);
+    }
+}
+
+void JobSystem::Exit()
+{
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        sData.Running = false;
+    }
+    sData.Condition.notify_all();
+
+    for (auto& worker : sData.Workers) {
+        worker.join();
+    }
+    sData.Workers.clear();
+}
+
+std::future<void> JobSystem::Submit(std::function<void()> job)
+{
+    auto task = std::make_shared<std::packaged_task<void()>>(std::move(job));
+    std::future<void> future = task->get_future();
+
+    // No workers (not initialized or already shut down): run inline
+    if (sData.Workers.empty()) {
+        (*task)();
+        return future;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        sData.Jobs.push([task]() { (*task)(); });
+    }
+    sData.Condition.notify_one();
+    return future;
+}
+
+void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn)
+{
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || sData.Workers.empty()) {
+        for (uint32_t i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    // Helpers may start after the caller already drained the range, so the state has to outlive this call.
+    struct State {
+        std::atomic<uint32_t> Next = 0;
+        std::atomic<uint32_t> Done = 0;
+        std::mutex Mutex;
+        std::condition_variable Finished;
+    };
+    auto state = std::make_shared<State>();
+
+    auto work = [state, count, &fn]() {
+        uint32_t completed = 0;
+        for (uint32_t i = state->Next++; i < count; i = state->Next++) {
+            fn(i);
+            completed++;
+        }
+        if (completed && state->Done.fetch_add(completed) + completed == count) {
+            std::lock_guard<std::mutex> lock(state->Mutex);
+            state->Finished.notify_all();
+        }
+    };
+
+    uint32_t helperCount = std::min<uint32_t>(static_cast<uint32_t>(sData.Workers.size()), count - 1);
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        for (uint32_t i = 0; i < helperCount; i++) {
+            // Late helpers only touch the shared state, never fn, once Next has passed count.
+            sData.Jobs.push(work);
+        }
+    }
+    sData.Condition.notify_all();
+
+    work();
+
+    std::unique_lock<std::mutex> lock(state->Mutex);
+    state->Finished.wait(lock, [&]() { return state->Done.load() == count; });
+}
+
+uint32_t JobSystem::GetThreadCount()
+{
+    return static_cast<uint32_t>(sData.Workers.size());
+}
+
+void JobSystem::WorkerLoop()
+{
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(sData.Mutex);
+            sData.Condition.wait(lock, []() { return !sData.Running || !sData.Jobs.empty(); });
+            if (!sData.Running && sData.Jobs.empty()) {
+                return;
+            }
+            job = std::move(sData.Jobs.front());
+            sData.Jobs.pop();
+        }
+        job();
+    }
+}
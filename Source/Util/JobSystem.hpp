@@ -0,0 +1,49 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-12 10:02:17
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+    Small fixed-size worker pool used for load-time CPU work (mesh decode, tangents, texture decode...).
+    Nothing in here touches the RHI: GPU resource creation stays on the main thread.
+*/
+
+class JobSystem
+{
+public:
+    /// @note(ame): threadCount == 0 means hardware_concurrency - 1 workers (the main thread helps out in ParallelFor).
+    static void Init(uint32_t threadCount = 0);
+    static void Exit();
+
+    static std::future<void> Submit(std::function<void()> job);
+
+    /// @note(ame): runs fn(0..count-1) across the workers and the calling thread, returns once every index is done.
+    /// Safe to call from inside a job: the caller never blocks on a job that hasn't started.
+    static void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn);
+
+    static uint32_t GetThreadCount();
+private:
+    static void WorkerLoop();
+
+    static struct Data {
+        std::vector<std::thread> Workers;
+        std::queue<std::function<void()>> Jobs;
+        std::mutex Mutex;
+        std::condition_variable Condition;
+        bool Running = false;
+    } sData;
+};
@@ -0,0 +1,125 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-20 10:31:05
+//
+
+#include "LinearArena.hpp"
+
+#include <Oslo/Core/Assert.hpp>
+
+#include <algorithm>
+#include <new>
+
+std::atomic<uint64_t> LinearArena::sAllocations = 0;
+std::atomic<uint64_t> LinearArena::sBlockAllocations = 0;
+std::atomic<uint64_t> LinearArena::sBytesAllocated = 0;
+
+LinearArena::LinearArena(size_t blockSize)
+    : mBlockSize(blockSize)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    for (const Block& block : mBlocks) {
+        FreeBlock(block);
+    }
+}
+
+uint8_t* LinearArena::AllocateBlock(size_t size)
+{
+    sBlockAllocations++;
+    return static_cast<uint8_t*>(operator new(size, std::align_val_t(ARENA_BLOCK_ALIGNMENT)));
+}
+
+void LinearArena::FreeBlock(const Block& block)
+{
+    operator delete(block.Data, std::align_val_t(ARENA_BLOCK_ALIGNMENT));
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+    ASSERT(alignment <= ARENA_BLOCK_ALIGNMENT, "Arena alignment is capped to the block alignment!");
+    alignment = std::max<size_t>(alignment, 16);
+    size = std::max<size_t>(size, 1);
+
+    sAllocations++;
+    sBytesAllocated += size;
+
+    if (!mBlocks.empty()) {
+        size_t offset = (mOffset + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= mBlocks[mBlock].Size) {
+            mOffset = offset + size;
+            return mBlocks[mBlock].Data + offset;
+        }
+        mBlock++;
+    }
+
+    // Next block, dropping it if it's too small for this request. Block starts are aligned, no padding needed
+    if (mBlock < mBlocks.size() && mBlocks[mBlock].Size < size) {
+        FreeBlock(mBlocks[mBlock]);
+        mBlocks.erase(mBlocks.begin() + mBlock);
+    }
+    if (mBlock == mBlocks.size() || mBlocks[mBlock].Size < size) {
+        size_t blockSize = std::max(mBlockSize, size);
+        mBlocks.insert(mBlocks.begin() + mBlock, Block{ AllocateBlock(blockSize), blockSize });
+    }
+
+    mOffset = size;
+    return mBlocks[mBlock].Data;
+}
+
+void LinearArena::Rewind(Marker marker)
+{
+    mBlock = marker.Block;
+    mOffset = marker.Offset;
+}
+
+void LinearArena::Reset()
+{
+    mBlock = 0;
+    mOffset = 0;
+    if (mBlocks.size() <= 1) {
+        return;
+    }
+
+    // Everything in one block next time, unless that gets unreasonable to keep around
+    size_t total = 0;
+    for (const Block& block : mBlocks) {
+        total += block.Size;
+        FreeBlock(block);
+    }
+    mBlocks.clear();
+
+    size_t retained = total <= ARENA_MAX_RETAINED_SIZE ? total : mBlockSize;
+    mBlocks.push_back(Block{ AllocateBlock(retained), retained });
+}
+
+LinearArena& LinearArena::ThreadLocal()
+{
+    thread_local LinearArena arena;
+    return arena;
+}
+
+ArenaStats LinearArena::GetStats()
+{
+    ArenaStats stats;
+    stats.Allocations = sAllocations;
+    stats.BlockAllocations = sBlockAllocations;
+    stats.BytesAllocated = sBytesAllocated;
+    return stats;
+}
+
+ArenaScope::ArenaScope(LinearArena& arena)
+    : Arena(arena), mMarker(arena.GetMarker())
+{
+    Arena.mScopeDepth++;
+}
+
+ArenaScope::~ArenaScope()
+{
+    Arena.Rewind(mMarker);
+    if (--Arena.mScopeDepth == 0) {
+        Arena.Reset();
+    }
+}
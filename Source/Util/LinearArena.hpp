@@ -0,0 +1,114 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-20 10:12:48
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+/*
+    Bump allocator for load-time temporaries (weld tables, tangent accumulators, reorder scratch, upload staging...).
+    Every thread gets its own arena through LinearArena::ThreadLocal(), so nothing is locked.
+    Memory is never freed per allocation: ArenaScope rewinds to where it started, and when the outermost scope of a thread
+    closes the arena is reset to a single block, grown to the high water mark so the next primitive/load fits in it.
+    Only trivially destructible types, nothing gets destructed.
+*/
+
+#define ARENA_BLOCK_SIZE (4ull * 1024 * 1024)
+#define ARENA_MAX_RETAINED_SIZE (32ull * 1024 * 1024)
+#define ARENA_BLOCK_ALIGNMENT 64
+
+/// @note(ame): totals over every arena since startup, diff two snapshots to measure a load.
+struct ArenaStats
+{
+    /// @note(ame): Allocate calls, each of these used to be its own heap allocation.
+    uint64_t Allocations = 0;
+    /// @note(ame): blocks the arenas had to get from the heap to serve them.
+    uint64_t BlockAllocations = 0;
+    uint64_t BytesAllocated = 0;
+};
+
+class LinearArena
+{
+public:
+    struct Marker
+    {
+        size_t Block;
+        size_t Offset;
+    };
+
+    explicit LinearArena(size_t blockSize = ARENA_BLOCK_SIZE);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /// @note(ame): uninitialized memory, alignment up to ARENA_BLOCK_ALIGNMENT.
+    void* Allocate(size_t size, size_t alignment = 16);
+
+    template<typename T>
+    T* Allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is never destructed!");
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    template<typename T>
+    T* Allocate(size_t count, const T& value)
+    {
+        T* data = Allocate<T>(count);
+        std::fill(data, data + count, value);
+        return data;
+    }
+
+    Marker GetMarker() const { return { mBlock, mOffset }; }
+    void Rewind(Marker marker);
+
+    /// @note(ame): everything handed out so far is invalid afterwards.
+    void Reset();
+
+    static LinearArena& ThreadLocal();
+    static ArenaStats GetStats();
+private:
+    struct Block
+    {
+        uint8_t* Data;
+        size_t Size;
+    };
+
+    uint8_t* AllocateBlock(size_t size);
+    void FreeBlock(const Block& block);
+
+    std::vector<Block> mBlocks;
+    size_t mBlock = 0;
+    size_t mOffset = 0;
+    size_t mBlockSize;
+    uint32_t mScopeDepth = 0;
+
+    friend class ArenaScope;
+
+    static std::atomic<uint64_t> sAllocations;
+    static std::atomic<uint64_t> sBlockAllocations;
+    static std::atomic<uint64_t> sBytesAllocated;
+};
+
+/// @note(ame): RAII rewind. The outermost scope on a thread resets the arena when it closes.
+class ArenaScope
+{
+public:
+    explicit ArenaScope(LinearArena& arena = LinearArena::ThreadLocal());
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    LinearArena& Arena;
+private:
+    LinearArena::Marker mMarker;
+};
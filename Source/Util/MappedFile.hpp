@@ -0,0 +1,36 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-13 11:20:35
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+/// @note(ame): read-only memory mapping of a whole file. Unmapped on Close() or destruction.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return mData != nullptr; }
+    const uint8_t* Data() const { return mData; }
+    uint64_t Size() const { return mSize; }
+private:
+    const uint8_t* mData = nullptr;
+    uint64_t mSize = 0;
+
+#ifdef _WIN32
+    void* mFile = nullptr;
+    void* mMapping = nullptr;
+#else
+    int mFile = -1;
+#endif
+};
@@ -0,0 +1,303 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-15 14:19:37
+//
+
+#include "MeshLocality.hpp"
+#include "LinearArena.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#define FORSYTH_CACHE_SIZE 32
+#define FORSYTH_MAX_VALENCE 64
+#define MEASURE_CACHE_SIZE 16
+
+void LocalityStats::Add(const LocalityStats& other)
+{
+    Triangles += other.Triangles;
+    Vertices += other.Vertices;
+    CacheMisses += other.CacheMisses;
+    IndexSpan += other.IndexSpan;
+}
+
+void MeshLocality::Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, TriangleOrder order)
+{
+    if (vertices.empty() || indices.size() < 3) {
+        return;
+    }
+
+    switch (order) {
+        case TriangleOrder::Forsyth:
+            OptimizeForsyth(indices.data(), indices.size(), vertices.size());
+            break;
+        case TriangleOrder::Morton:
+            OptimizeMorton(indices.data(), indices.size(), vertices.data(), vertices.size());
+            break;
+        case TriangleOrder::Original:
+            return;
+    }
+    RemapFirstUse(vertices, indices);
+}
+
+/// @note(ame): scoring constants straight from Forsyth's article.
+static struct ForsythTables
+{
+    float Cache[FORSYTH_CACHE_SIZE];
+    float Valence[FORSYTH_MAX_VALENCE];
+
+    ForsythTables()
+    {
+        const float cacheDecayPower = 1.5f;
+        const float lastTriScore = 0.75f;
+        const float valenceBoostScale = 2.0f;
+        const float valenceBoostPower = 0.5f;
+
+        for (int i = 0; i < FORSYTH_CACHE_SIZE; i++) {
+            if (i < 3) {
+                // The last triangle's vertices get a fixed score so we don't favour one of them over another
+                Cache[i] = lastTriScore;
+            } else {
+                float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                Cache[i] = powf(1.0f - (i - 3) * scaler, cacheDecayPower);
+            }
+        }
+
+        Valence[0] = 0.0f;
+        for (int i = 1; i < FORSYTH_MAX_VALENCE; i++) {
+            Valence[i] = valenceBoostScale * powf(static_cast<float>(i), -valenceBoostPower);
+        }
+    }
+} sForsyth;
+
+static inline float ForsythVertexScore(uint32_t liveTriangles, int cachePosition)
+{
+    if (liveTriangles == 0) {
+        return -1.0f;
+    }
+
+    float score = cachePosition >= 0 ? sForsyth.Cache[cachePosition] : 0.0f;
+    score += sForsyth.Valence[std::min(liveTriangles, static_cast<uint32_t>(FORSYTH_MAX_VALENCE - 1))];
+    return score;
+}
+
+void MeshLocality::OptimizeForsyth(uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    ArenaScope scope;
+    LinearArena& arena = scope.Arena;
+
+    // Vertex -> triangle adjacency, LiveTriangles[v] entries from AdjacencyOffset[v] are still to be emitted
+    uint32_t* liveTriangles = arena.Allocate<uint32_t>(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        liveTriangles[indices[i]]++;
+    }
+
+    uint32_t* adjacencyOffset = arena.Allocate<uint32_t>(vertexCount + 1, 0);
+    for (size_t i = 0; i < vertexCount; i++) {
+        adjacencyOffset[i + 1] = adjacencyOffset[i] + liveTriangles[i];
+    }
+
+    uint32_t* adjacency = arena.Allocate<uint32_t>(triangleCount * 3);
+    {
+        uint32_t* fill = arena.Allocate<uint32_t>(vertexCount);
+        std::copy(adjacencyOffset, adjacencyOffset + vertexCount, fill);
+        for (size_t i = 0; i < triangleCount; i++) {
+            for (int k = 0; k < 3; k++) {
+                adjacency[fill[indices[i * 3 + k]]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    int* cachePosition = arena.Allocate<int>(vertexCount, -1);
+    float* vertexScore = arena.Allocate<float>(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        vertexScore[i] = ForsythVertexScore(liveTriangles[i], -1);
+    }
+
+    uint8_t* emitted = arena.Allocate<uint8_t>(triangleCount, 0);
+
+    uint32_t* output = arena.Allocate<uint32_t>(triangleCount * 3);
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t cacheCount = 0;
+
+    size_t scanCursor = 0;
+    int64_t best = -1;
+    float bestScore = -FLT_MAX;
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        // Nothing useful in the cache: restart from the next triangle in file order
+        if (best < 0) {
+            while (emitted[scanCursor]) {
+                scanCursor++;
+            }
+            best = static_cast<int64_t>(scanCursor);
+        }
+
+        uint32_t triangle = static_cast<uint32_t>(best);
+        emitted[triangle] = 1;
+
+        uint32_t v[3] = { indices[triangle * 3 + 0], indices[triangle * 3 + 1], indices[triangle * 3 + 2] };
+        for (int k = 0; k < 3; k++) {
+            output[emittedCount * 3 + k] = v[k];
+
+            // Swap-remove the triangle from the vertex's live list
+            uint32_t* list = adjacency + adjacencyOffset[v[k]];
+            uint32_t& count = liveTriangles[v[k]];
+            for (uint32_t j = 0; j < count; j++) {
+                if (list[j] == triangle) {
+                    list[j] = list[count - 1];
+                    count--;
+                    break;
+                }
+            }
+        }
+
+        // New cache: the triangle's vertices in front, then the old entries that aren't part of it
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+        uint32_t newCount = 0;
+        for (int k = 0; k < 3; k++) {
+            newCache[newCount++] = v[k];
+        }
+        for (uint32_t j = 0; j < cacheCount; j++) {
+            uint32_t vertex = cache[j];
+            if (vertex != v[0] && vertex != v[1] && vertex != v[2]) {
+                newCache[newCount++] = vertex;
+            }
+        }
+
+        // Rescore every vertex that was or is in the cache, then every live triangle touching them
+        best = -1;
+        bestScore = -FLT_MAX;
+        for (uint32_t j = 0; j < newCount; j++) {
+            uint32_t vertex = newCache[j];
+            cachePosition[vertex] = j < FORSYTH_CACHE_SIZE ? static_cast<int>(j) : -1;
+            vertexScore[vertex] = ForsythVertexScore(liveTriangles[vertex], cachePosition[vertex]);
+        }
+        for (uint32_t j = 0; j < std::min(newCount, static_cast<uint32_t>(FORSYTH_CACHE_SIZE)); j++) {
+            uint32_t vertex = newCache[j];
+            const uint32_t* list = adjacency + adjacencyOffset[vertex];
+            for (uint32_t t = 0; t < liveTriangles[vertex]; t++) {
+                uint32_t candidate = list[t];
+                float score = vertexScore[indices[candidate * 3 + 0]] + vertexScore[indices[candidate * 3 + 1]] + vertexScore[indices[candidate * 3 + 2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = candidate;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, static_cast<uint32_t>(FORSYTH_CACHE_SIZE));
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    std::copy(output, output + triangleCount * 3, indices);
+}
+
+static inline uint32_t SpreadBits10(uint32_t x)
+{
+    x &= 0x3FF;
+    x = (x | (x << 16)) & 0x030000FF;
+    x = (x | (x << 8)) & 0x0300F00F;
+    x = (x | (x << 4)) & 0x030C30C3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+}
+
+void MeshLocality::OptimizeMorton(uint32_t* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    glm::vec3 min(FLT_MAX);
+    glm::vec3 max(-FLT_MAX);
+    for (size_t i = 0; i < vertexCount; i++) {
+        min = glm::min(min, vertices[i].Position);
+        max = glm::max(max, vertices[i].Position);
+    }
+    glm::vec3 extent = max - min;
+    glm::vec3 scale = glm::vec3(
+        extent.x > 0.0f ? 1023.0f / extent.x : 0.0f,
+        extent.y > 0.0f ? 1023.0f / extent.y : 0.0f,
+        extent.z > 0.0f ? 1023.0f / extent.z : 0.0f
+    );
+
+    ArenaScope scope;
+
+    // 30-bit code in the high half, triangle index in the low half: one sort, stable for free
+    uint64_t* keys = scope.Arena.Allocate<uint64_t>(triangleCount);
+    for (size_t i = 0; i < triangleCount; i++) {
+        glm::vec3 centroid = (vertices[indices[i * 3 + 0]].Position + vertices[indices[i * 3 + 1]].Position + vertices[indices[i * 3 + 2]].Position) / 3.0f;
+        glm::vec3 cell = (centroid - min) * scale;
+
+        uint32_t code = SpreadBits10(static_cast<uint32_t>(cell.x)) | (SpreadBits10(static_cast<uint32_t>(cell.y)) << 1) | (SpreadBits10(static_cast<uint32_t>(cell.z)) << 2);
+        keys[i] = (static_cast<uint64_t>(code) << 32) | i;
+    }
+    std::sort(keys, keys + triangleCount);
+
+    uint32_t* output = scope.Arena.Allocate<uint32_t>(triangleCount * 3);
+    for (size_t i = 0; i < triangleCount; i++) {
+        uint32_t triangle = static_cast<uint32_t>(keys[i] & 0xFFFFFFFF);
+        output[i * 3 + 0] = indices[triangle * 3 + 0];
+        output[i * 3 + 1] = indices[triangle * 3 + 1];
+        output[i * 3 + 2] = indices[triangle * 3 + 2];
+    }
+    std::copy(output, output + triangleCount * 3, indices);
+}
+
+void MeshLocality::RemapFirstUse(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    ArenaScope scope;
+    uint32_t* remap = scope.Arena.Allocate<uint32_t>(vertices.size(), UINT32_MAX);
+    Vertex* reordered = scope.Arena.Allocate<Vertex>(vertices.size());
+
+    uint32_t count = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = count;
+            reordered[count++] = vertices[index];
+        }
+        index = remap[index];
+    }
+
+    // Copied back so vertices keeps its allocation, unreferenced vertices fall off the end
+    std::copy(reordered, reordered + count, vertices.begin());
+    vertices.resize(count);
+}
+
+LocalityStats MeshLocality::Measure(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    LocalityStats stats;
+    stats.Triangles = indexCount / 3;
+
+    // FIFO post-transform cache, timestamps avoid clearing or shifting anything
+    ArenaScope scope;
+    uint64_t* insertedAt = scope.Arena.Allocate<uint64_t>(vertexCount, 0);
+    uint8_t* referenced = scope.Arena.Allocate<uint8_t>(vertexCount, 0);
+    uint64_t time = MEASURE_CACHE_SIZE + 1;
+    for (size_t i = 0; i < stats.Triangles * 3; i++) {
+        uint32_t index = indices[i];
+        if (time - insertedAt[index] > MEASURE_CACHE_SIZE) {
+            insertedAt[index] = time++;
+            stats.CacheMisses++;
+        }
+        if (!referenced[index]) {
+            referenced[index] = 1;
+            stats.Vertices++;
+        }
+    }
+
+    for (size_t i = 0; i < stats.Triangles; i++) {
+        uint32_t a = indices[i * 3 + 0];
+        uint32_t b = indices[i * 3 + 1];
+        uint32_t c = indices[i * 3 + 2];
+        stats.IndexSpan += std::max({ a, b, c }) - std::min({ a, b, c });
+    }
+    return stats;
+}
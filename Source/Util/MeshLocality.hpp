@@ -0,0 +1,56 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-15 14:06:51
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "TangentCalculator.hpp"
+
+/*
+    Load-time triangle/vertex reordering for memory locality.
+        - Forsyth: greedy post-transform cache optimization (Tom Forsyth, "Linear-Speed Vertex Cache Optimisation").
+        - Morton: triangles sorted along a Z-order curve of their centroids, cheaper and purely spatial.
+    Both are followed by a remap of the vertex array into first-use order so vertex fetches walk memory forwards.
+    Works on plain arrays so the cook path can run it offline as well.
+*/
+
+enum class TriangleOrder : uint32_t
+{
+    Original = 0,
+    Forsyth = 1,
+    Morton = 2
+};
+
+/// @note(ame): raw counters so stats of several primitives can be summed before dividing.
+struct LocalityStats
+{
+    uint64_t Triangles = 0;
+    uint64_t Vertices = 0;
+    uint64_t CacheMisses = 0;
+    uint64_t IndexSpan = 0;
+
+    /// @note(ame): cache misses per triangle with a 16 entry FIFO. 0.5 is the ideal on regular grids, 3.0 the worst case.
+    float ACMR() const { return Triangles ? CacheMisses / static_cast<float>(Triangles) : 0.0f; }
+    /// @note(ame): cache misses per vertex, 1.0 is optimal.
+    float ATVR() const { return Vertices ? CacheMisses / static_cast<float>(Vertices) : 0.0f; }
+    /// @note(ame): average (max index - min index) of a triangle, a proxy for how scattered vertex fetches are.
+    float AverageIndexSpan() const { return Triangles ? IndexSpan / static_cast<float>(Triangles) : 0.0f; }
+
+    void Add(const LocalityStats& other);
+};
+
+class MeshLocality
+{
+public:
+    /// @note(ame): reorders triangles, then vertices. Unreferenced vertices are dropped.
+    static void Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, TriangleOrder order);
+
+    static void OptimizeForsyth(uint32_t* indices, size_t indexCount, size_t vertexCount);
+    static void OptimizeMorton(uint32_t* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount);
+    static void RemapFirstUse(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    static LocalityStats Measure(const uint32_t* indices, size_t indexCount, size_t vertexCount);
+};
@@ -0,0 +1,437 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-17 11:58:42
+//
+
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <queue>
+
+/// @note(ame): symmetric 4x4 plane quadric, a00 a01 a02 a03 a11 a12 a13 a22 a23 a33, plus the total weight.
+struct Quadric
+{
+    double A[10] = {};
+    double W = 0.0;
+
+    void AddPlane(glm::vec3 n, float d, float weight)
+    {
+        double x = n.x, y = n.y, z = n.z, w = d;
+        A[0] += weight * x * x; A[1] += weight * x * y; A[2] += weight * x * z; A[3] += weight * x * w;
+        A[4] += weight * y * y; A[5] += weight * y * z; A[6] += weight * y * w;
+        A[7] += weight * z * z; A[8] += weight * z * w;
+        A[9] += weight * w * w;
+        W += weight;
+    }
+
+    void Add(const Quadric& other)
+    {
+        for (int i = 0; i < 10; i++) {
+            A[i] += other.A[i];
+        }
+        W += other.W;
+    }
+
+    /// @note(ame): weighted mean squared distance of p to the accumulated planes.
+    double Error(glm::vec3 p) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+        double error = x * x * A[0] + 2.0 * x * y * A[1] + 2.0 * x * z * A[2] + 2.0 * x * A[3]
+                     + y * y * A[4] + 2.0 * y * z * A[5] + 2.0 * y * A[6]
+                     + z * z * A[7] + 2.0 * z * A[8]
+                     + A[9];
+        return W > 0.0 ? std::max(error, 0.0) / W : 0.0;
+    }
+};
+
+struct Collapse
+{
+    float Cost;
+    float Error;
+    uint32_t From;
+    uint32_t To;
+    uint32_t FromStamp;
+    uint32_t ToStamp;
+
+    bool operator>(const Collapse& other) const { return Cost > other.Cost; }
+};
+
+static inline uint64_t EdgeKey(uint32_t a, uint32_t b)
+{
+    return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+
+float MeshSimplifier::Simplify(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float maxError, const SimplifyOptions& options, std::vector<uint32_t>& out)
+{
+    size_t triangleCount = indexCount / 3;
+    out.assign(indices, indices + triangleCount * 3);
+    if (triangleCount == 0 || targetIndexCount >= out.size()) {
+        return 0.0f;
+    }
+
+    // Work in [0, 1]: errors and attribute weights don't depend on the mesh size
+    glm::vec3 min(FLT_MAX);
+    glm::vec3 max(-FLT_MAX);
+    for (size_t i = 0; i < vertexCount; i++) {
+        min = glm::min(min, vertices[i].Position);
+        max = glm::max(max, vertices[i].Position);
+    }
+    float scale = std::max({ max.x - min.x, max.y - min.y, max.z - min.z });
+    if (!(scale > 0.0f)) {
+        return 0.0f;
+    }
+
+    std::vector<glm::vec3> positions(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        positions[i] = (vertices[i].Position - min) / scale;
+    }
+
+    // The collapse works on positions: vertices sharing one (UV/normal seams) form a group that moves as a whole.
+    // Groups are identified by their first vertex, only those index the per group arrays below. Open borders are locked
+    std::vector<uint32_t> canonical(vertexCount);
+    std::vector<bool> locked(vertexCount, false);
+    {
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0);
+        auto less = [&](uint32_t a, uint32_t b) {
+            const glm::vec3& pa = vertices[a].Position;
+            const glm::vec3& pb = vertices[b].Position;
+            if (pa.x != pb.x) return pa.x < pb.x;
+            if (pa.y != pb.y) return pa.y < pb.y;
+            if (pa.z != pb.z) return pa.z < pb.z;
+            return a < b;
+        };
+        std::sort(order.begin(), order.end(), less);
+
+        for (size_t i = 0; i < vertexCount;) {
+            size_t j = i + 1;
+            while (j < vertexCount && vertices[order[j]].Position == vertices[order[i]].Position) {
+                j++;
+            }
+            for (size_t k = i; k < j; k++) {
+                canonical[order[k]] = order[i];
+            }
+            i = j;
+        }
+
+        std::vector<uint64_t> edges;
+        edges.reserve(triangleCount * 3);
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = canonical[out[t * 3 + k]];
+                uint32_t b = canonical[out[t * 3 + (k + 1) % 3]];
+                if (a != b) {
+                    edges.push_back(EdgeKey(a, b));
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j] == edges[i]) {
+                j++;
+            }
+            if (j - i == 1) {
+                locked[edges[i] >> 32] = true;
+                locked[edges[i] & 0xFFFFFFFF] = true;
+            }
+            i = j;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<std::vector<uint32_t>> adjacency(vertexCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        uint32_t a = canonical[out[t * 3 + 0]];
+        uint32_t b = canonical[out[t * 3 + 1]];
+        uint32_t c = canonical[out[t * 3 + 2]];
+
+        glm::vec3 normal = glm::cross(positions[b] - positions[a], positions[c] - positions[a]);
+        float length = glm::length(normal);
+        if (length > 0.0f) {
+            normal /= length;
+            float d = -glm::dot(normal, positions[a]);
+            float area = length * 0.5f;
+            quadrics[a].AddPlane(normal, d, area);
+            quadrics[b].AddPlane(normal, d, area);
+            quadrics[c].AddPlane(normal, d, area);
+        }
+
+        adjacency[a].push_back(static_cast<uint32_t>(t));
+        if (b != a) {
+            adjacency[b].push_back(static_cast<uint32_t>(t));
+        }
+        if (c != a && c != b) {
+            adjacency[c].push_back(static_cast<uint32_t>(t));
+        }
+    }
+
+    std::vector<uint32_t> stamps(vertexCount, 0);
+    std::vector<bool> removed(vertexCount, false);
+    std::vector<bool> dead(triangleCount, false);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+    // Each vertex of the from group lands on the vertex of the to group it shares a triangle with, so a seam slides along itself.
+    // Fails when one of them has no such partner (it would leave its seam) or several (the collapse crosses a seam)
+    std::vector<std::pair<uint32_t, uint32_t>> wedges;
+    auto mapWedges = [&](uint32_t from, uint32_t to) {
+        wedges.clear();
+        for (uint32_t t : adjacency[from]) {
+            if (dead[t]) {
+                continue;
+            }
+            uint32_t a = UINT32_MAX;
+            uint32_t b = UINT32_MAX;
+            for (int k = 0; k < 3; k++) {
+                uint32_t vertex = out[t * 3 + k];
+                if (canonical[vertex] == from) {
+                    a = vertex;
+                } else if (canonical[vertex] == to) {
+                    b = vertex;
+                }
+            }
+            wedges.push_back({ a, b });
+        }
+        std::sort(wedges.begin(), wedges.end());
+        wedges.erase(std::unique(wedges.begin(), wedges.end()), wedges.end());
+
+        // Sorted by vertex, the pairs without a partner come last in each run
+        size_t written = 0;
+        for (size_t i = 0; i < wedges.size();) {
+            size_t j = i + 1;
+            while (j < wedges.size() && wedges[j].first == wedges[i].first) {
+                j++;
+            }
+            if (wedges[i].second == UINT32_MAX || (j - i > 1 && wedges[i + 1].second != UINT32_MAX)) {
+                return false;
+            }
+            wedges[written++] = wedges[i];
+            i = j;
+        }
+        wedges.resize(written);
+        return true;
+    };
+
+    auto pushEdge = [&](uint32_t a, uint32_t b) {
+        Quadric merged = quadrics[a];
+        merged.Add(quadrics[b]);
+
+        // Attribute cost of the worst vertex pair the collapse merges
+        auto attributeCost = [&]() {
+            float cost = 0.0f;
+            for (auto [from, to] : wedges) {
+                glm::vec3 normalDelta = vertices[from].Normal - vertices[to].Normal;
+                glm::vec2 uvDelta = vertices[from].UV - vertices[to].UV;
+                cost = std::max(cost, options.NormalWeight * glm::dot(normalDelta, normalDelta) + options.UVWeight * glm::dot(uvDelta, uvDelta));
+            }
+            return cost;
+        };
+
+        // Collapse toward whichever end moves the surface least
+        Collapse best = {};
+        best.Cost = FLT_MAX;
+        if (!locked[a] && mapWedges(a, b)) {
+            float error = static_cast<float>(merged.Error(positions[b]));
+            best = { error + attributeCost(), error, a, b, stamps[a], stamps[b] };
+        }
+        if (!locked[b] && mapWedges(b, a)) {
+            float error = static_cast<float>(merged.Error(positions[a]));
+            float cost = error + attributeCost();
+            if (cost < best.Cost) {
+                best = { cost, error, b, a, stamps[b], stamps[a] };
+            }
+        }
+        if (best.Cost != FLT_MAX) {
+            heap.push(best);
+        }
+    };
+
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(triangleCount * 3);
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = canonical[out[t * 3 + k]];
+                uint32_t b = canonical[out[t * 3 + (k + 1) % 3]];
+                if (a != b) {
+                    edges.push_back(EdgeKey(a, b));
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        for (uint64_t edge : edges) {
+            pushEdge(static_cast<uint32_t>(edge >> 32), static_cast<uint32_t>(edge & 0xFFFFFFFF));
+        }
+    }
+
+    float errorLimit = (maxError / scale) * (maxError / scale);
+    float worstError = 0.0f;
+    size_t liveIndices = out.size();
+    std::vector<uint32_t> neighbours;
+    while (liveIndices > targetIndexCount && !heap.empty()) {
+        Collapse collapse = heap.top();
+        heap.pop();
+
+        uint32_t from = collapse.From;
+        uint32_t to = collapse.To;
+        if (removed[from] || removed[to] || stamps[from] != collapse.FromStamp || stamps[to] != collapse.ToStamp) {
+            continue;
+        }
+        if (collapse.Error > errorLimit) {
+            continue;
+        }
+
+        // Reject collapses that flip or squash a surviving triangle
+        auto touches = [&](const uint32_t* triangle, uint32_t group) {
+            return canonical[triangle[0]] == group || canonical[triangle[1]] == group || canonical[triangle[2]] == group;
+        };
+        bool flips = false;
+        for (uint32_t t : adjacency[from]) {
+            if (dead[t]) {
+                continue;
+            }
+            const uint32_t* triangle = &out[t * 3];
+            if (touches(triangle, to)) {
+                continue;
+            }
+
+            glm::vec3 p[3];
+            glm::vec3 q[3];
+            for (int k = 0; k < 3; k++) {
+                p[k] = positions[triangle[k]];
+                q[k] = canonical[triangle[k]] == from ? positions[to] : p[k];
+            }
+            glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+            if (glm::dot(before, after) <= 0.0f) {
+                flips = true;
+                break;
+            }
+        }
+        if (flips || !mapWedges(from, to)) {
+            continue;
+        }
+
+        removed[from] = true;
+        quadrics[to].Add(quadrics[from]);
+        for (uint32_t t : adjacency[from]) {
+            if (dead[t]) {
+                continue;
+            }
+            uint32_t* triangle = &out[t * 3];
+            if (touches(triangle, to)) {
+                dead[t] = true;
+                liveIndices -= 3;
+                continue;
+            }
+            for (int k = 0; k < 3; k++) {
+                if (canonical[triangle[k]] == from) {
+                    auto wedge = std::lower_bound(wedges.begin(), wedges.end(), std::make_pair(triangle[k], 0u));
+                    triangle[k] = wedge->second;
+                }
+            }
+            adjacency[to].push_back(t);
+        }
+        adjacency[from].clear();
+        adjacency[from].shrink_to_fit();
+        stamps[to]++;
+        worstError = std::max(worstError, collapse.Error);
+
+        // Drop dead triangles from the survivor's list and re-queue its edges with the merged quadric
+        auto& list = adjacency[to];
+        list.erase(std::remove_if(list.begin(), list.end(), [&](uint32_t t) { return dead[t]; }), list.end());
+
+        neighbours.clear();
+        for (uint32_t t : list) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t group = canonical[out[t * 3 + k]];
+                if (group != to) {
+                    neighbours.push_back(group);
+                }
+            }
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        for (uint32_t neighbour : neighbours) {
+            pushEdge(to, neighbour);
+        }
+    }
+
+    size_t written = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (!dead[t]) {
+            out[written++] = out[t * 3 + 0];
+            out[written++] = out[t * 3 + 1];
+            out[written++] = out[t * 3 + 2];
+        }
+    }
+    out.resize(written);
+
+    return std::sqrt(worstError) * scale;
+}
+
+void MeshSimplifier::BuildLODChain(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, const LODOptions& options, std::vector<uint32_t>& lodIndices, std::vector<LODLevel>& levels)
+{
+    lodIndices.clear();
+    levels.clear();
+
+    glm::vec3 min(FLT_MAX);
+    glm::vec3 max(-FLT_MAX);
+    for (size_t i = 0; i < vertexCount; i++) {
+        min = glm::min(min, vertices[i].Position);
+        max = glm::max(max, vertices[i].Position);
+    }
+    float maxError = options.MaxRelativeError * std::max({ max.x - min.x, max.y - min.y, max.z - min.z, 0.0f });
+
+    // Each level simplifies the previous one, errors add up (triangle inequality) so they stay conservative
+    std::vector<uint32_t> source(indices, indices + indexCount - indexCount % 3);
+    std::vector<uint32_t> simplified;
+    float error = 0.0f;
+    for (uint32_t level = 0; level < options.MaxLevels; level++) {
+        size_t targetTriangles = static_cast<size_t>(source.size() / 3 * options.Ratio);
+        if (targetTriangles < options.MinTriangles || error >= maxError) {
+            break;
+        }
+
+        float levelError = Simplify(vertices, vertexCount, source.data(), source.size(), targetTriangles * 3, maxError - error, options.Simplify, simplified);
+
+        // Locked borders/seams or the error budget stopped it: another level wouldn't be worth its memory
+        if (simplified.size() * 10 > source.size() * 9) {
+            break;
+        }
+
+        error += levelError;
+        levels.push_back({ static_cast<uint32_t>(lodIndices.size()), static_cast<uint32_t>(simplified.size()), error, 0 });
+        lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.end());
+        std::swap(source, simplified);
+    }
+}
+
+uint32_t MeshSimplifier::SelectLOD(const LODLevel* levels, uint32_t levelCount, float footprint, float scale)
+{
+    for (uint32_t i = levelCount; i > 0; i--) {
+        if (levels[i - 1].Error * scale <= footprint) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+uint32_t MeshSimplifier::SelectLODByDistance(const LODLevel* levels, uint32_t levelCount, float distance, float pixelAngle, float scale)
+{
+    return SelectLOD(levels, levelCount, distance * std::tan(pixelAngle), scale);
+}
+
+float MeshSimplifier::MaxScale(const glm::mat4& transform)
+{
+    float x = glm::length(glm::vec3(transform[0]));
+    float y = glm::length(glm::vec3(transform[1]));
+    float z = glm::length(glm::vec3(transform[2]));
+    return std::max(x, std::max(y, z));
+}
@@ -0,0 +1,72 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-17 11:26:09
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "TangentCalculator.hpp"
+
+/*
+    Quadric error metric edge collapse simplification (Garland & Heckbert), collapsing onto existing vertices only.
+    LOD levels are therefore plain index buffers over the primitive's own vertex buffer.
+        - quadrics are area weighted and averaged, so the error of a collapse is an RMS distance to the original planes
+        - normal/UV differences across a collapse are added to its cost (attribute weighting) but not to the reported error
+        - vertices sharing a position (UV/normal seams) are welded for the quadrics and collapse together, each onto the vertex
+          on its side of the seam: seams slide along themselves and never tear. Seam corners (three charts or more) stay put
+        - vertices on open borders are locked, the silhouette never moves
+        - collapses that flip a triangle are rejected
+    Reported errors are in the mesh's units: an LOD with Error e stays within roughly e of the original surface.
+    CPU only for now: GLTF cooks the chain and keeps the errors, but no level is uploaded and there is no BLAS per level,
+    so every ray, secondary bounces included, still traces the full mesh. SelectLOD has no GPU caller yet.
+*/
+
+#define LOD_MAX_LEVELS 6
+
+struct SimplifyOptions
+{
+    /// @note(ame): weight of |n0 - n1|^2 and |uv0 - uv1|^2, relative to squared distances normalized by the mesh extent.
+    float NormalWeight = 0.01f;
+    float UVWeight = 0.01f;
+};
+
+struct LODOptions
+{
+    /// @note(ame): each level targets Ratio times the triangles of the previous one.
+    float Ratio = 0.5f;
+    uint32_t MaxLevels = LOD_MAX_LEVELS;
+    uint32_t MinTriangles = 64;
+    /// @note(ame): stop once a level strays further than this from the original, relative to the mesh extent.
+    float MaxRelativeError = 0.05f;
+    SimplifyOptions Simplify;
+};
+
+/// @note(ame): level i of the chain is LODIndices[FirstIndex, FirstIndex + IndexCount). Level 0 (the source mesh) isn't stored.
+struct LODLevel
+{
+    uint32_t FirstIndex;
+    uint32_t IndexCount;
+    float Error;
+    uint32_t Pad;
+};
+
+class MeshSimplifier
+{
+public:
+    /// @note(ame): returns the error of the result in mesh units, out gets at least targetIndexCount indices unless maxError stops it first.
+    static float Simplify(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float maxError, const SimplifyOptions& options, std::vector<uint32_t>& out);
+
+    /// @note(ame): levels are ordered from finest to coarsest with non-decreasing Error.
+    static void BuildLODChain(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, const LODOptions& options, std::vector<uint32_t>& lodIndices, std::vector<LODLevel>& levels);
+
+    /// @note(ame): coarsest level whose error fits in footprint (world space size of a pixel or of a ray cone at the hit).
+    /// Errors are in mesh units, scale brings them to world space (see MaxScale). Returns 0 for the source mesh, i + 1 for levels[i].
+    static uint32_t SelectLOD(const LODLevel* levels, uint32_t levelCount, float footprint, float scale = 1.0f);
+    /// @note(ame): same, with the footprint of a pinhole pixel of angular size pixelAngle (radians) at world space distance.
+    static uint32_t SelectLODByDistance(const LODLevel* levels, uint32_t levelCount, float distance, float pixelAngle, float scale = 1.0f);
+
+    /// @note(ame): largest axis scale of a transform, an upper bound of how much it stretches mesh space errors.
+    static float MaxScale(const glm::mat4& transform);
+};
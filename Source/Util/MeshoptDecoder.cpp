@@ -0,0 +1,546 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-19 11:07:30
+//
+
+#include "MeshoptDecoder.hpp"
+#include "JobSystem.hpp"
+
+#include <Oslo/Core/Assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#define MESHOPT_VERTEX_HEADER 0xA0
+#define MESHOPT_INDEX_HEADER 0xE0
+#define MESHOPT_SEQUENCE_HEADER 0xD0
+
+#define MESHOPT_BYTE_GROUP_SIZE 16
+#define MESHOPT_BYTE_GROUP_DECODE_LIMIT 24
+#define MESHOPT_VERTEX_BLOCK_SIZE_BYTES 8192
+#define MESHOPT_VERTEX_BLOCK_MAX_SIZE 256
+#define MESHOPT_TAIL_MAX_SIZE 32
+
+//
+// ATTRIBUTES
+//
+
+static const uint8_t* DecodeBytesGroup(const uint8_t* data, uint8_t* buffer, int bitslog2)
+{
+    switch (bitslog2) {
+        case 0:
+            memset(buffer, 0, MESHOPT_BYTE_GROUP_SIZE);
+            return data;
+        case 1:
+        case 2: {
+            // Packed values MSB first, the all ones value means "the real byte follows the packed block"
+            const int bits = 1 << bitslog2;
+            const uint8_t sentinel = static_cast<uint8_t>((1 << bits) - 1);
+            const uint8_t* variable = data + bits * 2;
+            for (int i = 0; i < MESHOPT_BYTE_GROUP_SIZE; i++) {
+                int shift = 8 - bits - (i * bits) % 8;
+                uint8_t value = (data[(i * bits) / 8] >> shift) & sentinel;
+                if (value == sentinel) {
+                    value = *variable++;
+                }
+                buffer[i] = value;
+            }
+            return variable;
+        }
+        case 3:
+            memcpy(buffer, data, MESHOPT_BYTE_GROUP_SIZE);
+            return data + MESHOPT_BYTE_GROUP_SIZE;
+    }
+    return nullptr;
+}
+
+static const uint8_t* DecodeBytes(const uint8_t* data, const uint8_t* end, uint8_t* buffer, size_t bufferSize)
+{
+    // 2 bit mode per group of 16 bytes
+    size_t headerSize = (bufferSize / MESHOPT_BYTE_GROUP_SIZE + 3) / 4;
+    if (static_cast<size_t>(end - data) < headerSize) {
+        return nullptr;
+    }
+    const uint8_t* header = data;
+    data += headerSize;
+
+    for (size_t i = 0; i < bufferSize; i += MESHOPT_BYTE_GROUP_SIZE) {
+        // The tail padding guarantees a full group can always be read once this passes
+        if (static_cast<size_t>(end - data) < MESHOPT_BYTE_GROUP_DECODE_LIMIT) {
+            return nullptr;
+        }
+        size_t group = i / MESHOPT_BYTE_GROUP_SIZE;
+        int bitslog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+        data = DecodeBytesGroup(data, buffer + i, bitslog2);
+    }
+    return data;
+}
+
+static inline uint8_t Unzigzag8(uint8_t value)
+{
+    return static_cast<uint8_t>(-(value & 1) ^ (value >> 1));
+}
+
+static const uint8_t* DecodeVertexBlock(const uint8_t* data, const uint8_t* end, uint8_t* dst, size_t count, size_t stride, uint8_t* lastVertex)
+{
+    uint8_t buffer[MESHOPT_VERTEX_BLOCK_MAX_SIZE];
+    size_t alignedCount = (count + MESHOPT_BYTE_GROUP_SIZE - 1) & ~static_cast<size_t>(MESHOPT_BYTE_GROUP_SIZE - 1);
+
+    // One byte lane at a time, each lane is a delta chain starting from the previous block's last vertex
+    for (size_t k = 0; k < stride; k++) {
+        data = DecodeBytes(data, end, buffer, alignedCount);
+        if (!data) {
+            return nullptr;
+        }
+
+        uint8_t p = lastVertex[k];
+        for (size_t i = 0; i < count; i++) {
+            p = static_cast<uint8_t>(p + Unzigzag8(buffer[i]));
+            dst[i * stride + k] = p;
+        }
+        lastVertex[k] = p;
+    }
+    return data;
+}
+
+bool MeshoptDecoder::DecodeVertexBuffer(void* dst, size_t count, size_t stride, const uint8_t* src, size_t size)
+{
+    if (stride == 0 || stride > 256 || stride % 4 != 0) {
+        return false;
+    }
+    if (size < 1 + stride) {
+        return false;
+    }
+    if ((src[0] & 0xF0) != MESHOPT_VERTEX_HEADER || (src[0] & 0x0F) > 0) {
+        return false;
+    }
+
+    const uint8_t* data = src + 1;
+    const uint8_t* end = src + size;
+
+    // The stream ends with the baseline vertex
+    uint8_t lastVertex[256];
+    memcpy(lastVertex, end - stride, stride);
+
+    size_t blockSize = std::min((MESHOPT_VERTEX_BLOCK_SIZE_BYTES / stride) & ~static_cast<size_t>(MESHOPT_BYTE_GROUP_SIZE - 1), static_cast<size_t>(MESHOPT_VERTEX_BLOCK_MAX_SIZE));
+
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    for (size_t offset = 0; offset < count; offset += blockSize) {
+        size_t blockCount = std::min(blockSize, count - offset);
+        data = DecodeVertexBlock(data, end, out + offset * stride, blockCount, stride, lastVertex);
+        if (!data) {
+            return false;
+        }
+    }
+
+    size_t tailSize = stride < MESHOPT_TAIL_MAX_SIZE ? MESHOPT_TAIL_MAX_SIZE : stride;
+    return static_cast<size_t>(end - data) == tailSize;
+}
+
+//
+// TRIANGLES / INDICES
+//
+
+static inline uint32_t DecodeVByte(const uint8_t*& data)
+{
+    uint8_t lead = *data++;
+    if (lead < 128) {
+        return lead;
+    }
+
+    // Up to 5 bytes, 7 bits each, little endian
+    uint32_t result = lead & 127;
+    uint32_t shift = 7;
+    for (int i = 0; i < 4; i++) {
+        uint8_t group = *data++;
+        result |= static_cast<uint32_t>(group & 127) << shift;
+        shift += 7;
+        if (group < 128) {
+            break;
+        }
+    }
+    return result;
+}
+
+static inline uint32_t DecodeIndex(const uint8_t*& data, uint32_t last)
+{
+    uint32_t v = DecodeVByte(data);
+    uint32_t delta = (v >> 1) ^ static_cast<uint32_t>(-static_cast<int32_t>(v & 1));
+    return last + delta;
+}
+
+static inline void WriteIndex(void* dst, size_t i, size_t indexSize, uint32_t index)
+{
+    if (indexSize == 2) {
+        static_cast<uint16_t*>(dst)[i] = static_cast<uint16_t>(index);
+    } else {
+        static_cast<uint32_t*>(dst)[i] = index;
+    }
+}
+
+struct MeshoptIndexFifo
+{
+    uint32_t Edges[16][2];
+    uint32_t Vertices[16];
+    uint32_t EdgeOffset = 0;
+    uint32_t VertexOffset = 0;
+
+    MeshoptIndexFifo()
+    {
+        memset(Edges, 0xFF, sizeof(Edges));
+        memset(Vertices, 0xFF, sizeof(Vertices));
+    }
+
+    void PushEdge(uint32_t a, uint32_t b)
+    {
+        Edges[EdgeOffset][0] = a;
+        Edges[EdgeOffset][1] = b;
+        EdgeOffset = (EdgeOffset + 1) & 15;
+    }
+
+    /// @note(ame): the encoder only pushes vertices that aren't already in the FIFO, cond mirrors that.
+    void PushVertex(uint32_t v, bool cond = true)
+    {
+        Vertices[VertexOffset] = v;
+        VertexOffset = (VertexOffset + (cond ? 1 : 0)) & 15;
+    }
+
+    uint32_t Vertex(int back) const
+    {
+        return Vertices[(VertexOffset - back) & 15];
+    }
+};
+
+bool MeshoptDecoder::DecodeIndexBuffer(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t size)
+{
+    if (count % 3 != 0 || (indexSize != 2 && indexSize != 4)) {
+        return false;
+    }
+    if (size < 1 + count / 3 + 16) {
+        return false;
+    }
+    if ((src[0] & 0xF0) != MESHOPT_INDEX_HEADER) {
+        return false;
+    }
+    int version = src[0] & 0x0F;
+    if (version > 1) {
+        return false;
+    }
+
+    MeshoptIndexFifo fifo;
+    uint32_t next = 0;
+    uint32_t last = 0;
+    // Version 1 spends FIFO slots 13/14 on +-1 deltas from the last free index
+    int fecMax = version >= 1 ? 13 : 15;
+
+    // One code byte per triangle, then the variable length data, then a 16 byte codeaux table
+    const uint8_t* code = src + 1;
+    const uint8_t* data = code + count / 3;
+    const uint8_t* dataSafeEnd = src + size - 16;
+    const uint8_t* codeauxTable = dataSafeEnd;
+
+    for (size_t i = 0; i < count; i += 3) {
+        if (data > dataSafeEnd) {
+            return false;
+        }
+
+        uint8_t codetri = *code++;
+        if (codetri < 0xF0) {
+            // Edge from the FIFO plus one vertex: new, from the FIFO, or free
+            int fe = codetri >> 4;
+            uint32_t a = fifo.Edges[(fifo.EdgeOffset - 1 - fe) & 15][0];
+            uint32_t b = fifo.Edges[(fifo.EdgeOffset - 1 - fe) & 15][1];
+
+            int fec = codetri & 15;
+            uint32_t c;
+            if (fec < fecMax) {
+                c = fec == 0 ? next : fifo.Vertex(1 + fec);
+                next += fec == 0 ? 1 : 0;
+                fifo.PushVertex(c, fec == 0);
+            } else {
+                last = c = fec != 15 ? last + (fec - (fec ^ 3)) : DecodeIndex(data, last);
+                fifo.PushVertex(c);
+            }
+
+            WriteIndex(dst, i + 0, indexSize, a);
+            WriteIndex(dst, i + 1, indexSize, b);
+            WriteIndex(dst, i + 2, indexSize, c);
+            fifo.PushEdge(c, b);
+            fifo.PushEdge(a, c);
+        } else {
+            // No shared edge: three vertices described by a codeaux byte, from the table or inline
+            uint32_t a;
+            uint32_t b;
+            uint32_t c;
+            int feb;
+            int fec;
+            if (codetri < 0xFE) {
+                uint8_t codeaux = codeauxTable[codetri & 15];
+                feb = codeaux >> 4;
+                fec = codeaux & 15;
+
+                // next is bumped for every new vertex before the next one is read, same as the encoder
+                a = next++;
+                b = feb == 0 ? next++ : fifo.Vertex(feb);
+                c = fec == 0 ? next++ : fifo.Vertex(fec);
+            } else {
+                uint8_t codeaux = *data++;
+                int fea = codetri == 0xFE ? 0 : 15;
+                feb = codeaux >> 4;
+                fec = codeaux & 15;
+
+                // codeaux 0 outside the table is a restart
+                if (codeaux == 0) {
+                    next = 0;
+                }
+
+                a = fea == 0 ? next++ : 0;
+                b = feb == 0 ? next++ : fifo.Vertex(feb);
+                c = fec == 0 ? next++ : fifo.Vertex(fec);
+
+                if (fea == 15) {
+                    last = a = DecodeIndex(data, last);
+                }
+                if (feb == 15) {
+                    last = b = DecodeIndex(data, last);
+                }
+                if (fec == 15) {
+                    last = c = DecodeIndex(data, last);
+                }
+            }
+
+            WriteIndex(dst, i + 0, indexSize, a);
+            WriteIndex(dst, i + 1, indexSize, b);
+            WriteIndex(dst, i + 2, indexSize, c);
+            fifo.PushVertex(a);
+            fifo.PushVertex(b, feb == 0 || feb == 15);
+            fifo.PushVertex(c, fec == 0 || fec == 15);
+            fifo.PushEdge(b, a);
+            fifo.PushEdge(c, b);
+            fifo.PushEdge(a, c);
+        }
+    }
+
+    // Everything read, stopped right at the codeaux table
+    return data == dataSafeEnd;
+}
+
+bool MeshoptDecoder::DecodeIndexSequence(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t size)
+{
+    if (indexSize != 2 && indexSize != 4) {
+        return false;
+    }
+    // Header, at least a byte per index, 4 byte tail
+    if (size < 1 + count + 4) {
+        return false;
+    }
+    if ((src[0] & 0xF0) != MESHOPT_SEQUENCE_HEADER || (src[0] & 0x0F) > 1) {
+        return false;
+    }
+
+    const uint8_t* data = src + 1;
+    const uint8_t* dataSafeEnd = src + size - 4;
+
+    // Two baselines, the low bit of each value picks which one the delta applies to
+    uint32_t last[2] = { 0, 0 };
+    for (size_t i = 0; i < count; i++) {
+        if (data >= dataSafeEnd) {
+            return false;
+        }
+
+        uint32_t v = DecodeVByte(data);
+        uint32_t baseline = v & 1;
+        v >>= 1;
+
+        uint32_t delta = (v >> 1) ^ static_cast<uint32_t>(-static_cast<int32_t>(v & 1));
+        uint32_t index = last[baseline] + delta;
+        last[baseline] = index;
+
+        WriteIndex(dst, i, indexSize, index);
+    }
+    return data == dataSafeEnd;
+}
+
+//
+// FILTERS
+//
+
+static inline int RoundToInt(float value)
+{
+    return static_cast<int>(value + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+template<typename T>
+static void DecodeFilterOctahedral(T* data, size_t count)
+{
+    const float max = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+    for (size_t i = 0; i < count; i++) {
+        // z carries the encoding's 1.0 so we can rebuild it from x and y
+        float x = static_cast<float>(data[i * 4 + 0]);
+        float y = static_cast<float>(data[i * 4 + 1]);
+        float z = static_cast<float>(data[i * 4 + 2]) - fabsf(x) - fabsf(y);
+
+        // Unfold the lower hemisphere
+        float t = z >= 0.0f ? 0.0f : z;
+        x += x >= 0.0f ? t : -t;
+        y += y >= 0.0f ? t : -t;
+
+        float s = max / sqrtf(x * x + y * y + z * z);
+        data[i * 4 + 0] = static_cast<T>(RoundToInt(x * s));
+        data[i * 4 + 1] = static_cast<T>(RoundToInt(y * s));
+        data[i * 4 + 2] = static_cast<T>(RoundToInt(z * s));
+    }
+}
+
+static void DecodeFilterQuaternion(int16_t* data, size_t count)
+{
+    const float scale = 1.0f / sqrtf(2.0f);
+    for (size_t i = 0; i < count; i++) {
+        // The 4th component holds the range in its high bits and the index of the dropped component in the low 2
+        int range = data[i * 4 + 3] | 3;
+        float ss = scale / static_cast<float>(range);
+
+        float x = static_cast<float>(data[i * 4 + 0]) * ss;
+        float y = static_cast<float>(data[i * 4 + 1]) * ss;
+        float z = static_cast<float>(data[i * 4 + 2]) * ss;
+
+        float ww = 1.0f - x * x - y * y - z * z;
+        float w = sqrtf(ww >= 0.0f ? ww : 0.0f);
+
+        int qc = data[i * 4 + 3] & 3;
+        data[i * 4 + ((qc + 1) & 3)] = static_cast<int16_t>(RoundToInt(x * 32767.0f));
+        data[i * 4 + ((qc + 2) & 3)] = static_cast<int16_t>(RoundToInt(y * 32767.0f));
+        data[i * 4 + ((qc + 3) & 3)] = static_cast<int16_t>(RoundToInt(z * 32767.0f));
+        data[i * 4 + ((qc + 0) & 3)] = static_cast<int16_t>(RoundToInt(w * 32767.0f));
+    }
+}
+
+static void DecodeFilterExponential(uint32_t* data, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        // 24 bit signed mantissa, 8 bit signed exponent
+        uint32_t v = data[i];
+        int32_t m = static_cast<int32_t>(v << 8) >> 8;
+        int32_t e = static_cast<int32_t>(v) >> 24;
+
+        // ldexp(m, e) without the libm call: build 2^e directly
+        uint32_t bits = static_cast<uint32_t>(e + 127) << 23;
+        float scale;
+        memcpy(&scale, &bits, sizeof(float));
+        float value = scale * static_cast<float>(m);
+        memcpy(&data[i], &value, sizeof(float));
+    }
+}
+
+void MeshoptDecoder::ApplyFilter(void* data, size_t count, size_t stride, MeshoptFilter filter)
+{
+    switch (filter) {
+        case MeshoptFilter::Octahedral:
+            ASSERT(stride == 4 || stride == 8, "Octahedral meshopt filter needs a 4 or 8 byte stride!");
+            if (stride == 4) {
+                DecodeFilterOctahedral(static_cast<int8_t*>(data), count);
+            } else {
+                DecodeFilterOctahedral(static_cast<int16_t*>(data), count);
+            }
+            break;
+        case MeshoptFilter::Quaternion:
+            ASSERT(stride == 8, "Quaternion meshopt filter needs an 8 byte stride!");
+            DecodeFilterQuaternion(static_cast<int16_t*>(data), count);
+            break;
+        case MeshoptFilter::Exponential:
+            ASSERT(stride % 4 == 0, "Exponential meshopt filter needs a stride multiple of 4!");
+            DecodeFilterExponential(static_cast<uint32_t*>(data), count * (stride / 4));
+            break;
+        case MeshoptFilter::None:
+            break;
+    }
+}
+
+//
+// glTF
+//
+
+static MeshoptFilter ConvertFilter(cgltf_meshopt_compression_filter filter)
+{
+    switch (filter) {
+        case cgltf_meshopt_compression_filter_octahedral: return MeshoptFilter::Octahedral;
+        case cgltf_meshopt_compression_filter_quaternion: return MeshoptFilter::Quaternion;
+        case cgltf_meshopt_compression_filter_exponential: return MeshoptFilter::Exponential;
+        default: return MeshoptFilter::None;
+    }
+}
+
+static bool DecompressBufferView(cgltf_buffer_view* view)
+{
+    const cgltf_meshopt_compression& compression = view->meshopt_compression;
+    if (!compression.buffer || !compression.buffer->data || compression.offset + compression.size > compression.buffer->size) {
+        return false;
+    }
+    const uint8_t* src = static_cast<const uint8_t*>(compression.buffer->data) + compression.offset;
+
+    // Allocated with malloc: cgltf_free releases buffer_view->data with the default allocator
+    size_t decodedSize = compression.count * compression.stride;
+    void* dst = malloc(decodedSize > 0 ? decodedSize : 1);
+
+    bool result = false;
+    switch (compression.mode) {
+        case cgltf_meshopt_compression_mode_attributes:
+            result = MeshoptDecoder::DecodeVertexBuffer(dst, compression.count, compression.stride, src, compression.size);
+            if (result) {
+                MeshoptDecoder::ApplyFilter(dst, compression.count, compression.stride, ConvertFilter(compression.filter));
+            }
+            break;
+        case cgltf_meshopt_compression_mode_triangles:
+            result = MeshoptDecoder::DecodeIndexBuffer(dst, compression.count, compression.stride, src, compression.size);
+            break;
+        case cgltf_meshopt_compression_mode_indices:
+            result = MeshoptDecoder::DecodeIndexSequence(dst, compression.count, compression.stride, src, compression.size);
+            break;
+        default:
+            break;
+    }
+
+    if (!result) {
+        free(dst);
+        return false;
+    }
+    view->data = dst;
+    return true;
+}
+
+uint32_t MeshoptDecoder::DecompressBufferViews(cgltf_data* data, bool parallel)
+{
+    std::vector<cgltf_buffer_view*> views;
+    for (size_t i = 0; i < data->buffer_views_count; i++) {
+        cgltf_buffer_view* view = &data->buffer_views[i];
+        if (view->has_meshopt_compression && !view->data) {
+            views.push_back(view);
+        }
+    }
+    if (views.empty()) {
+        return 0;
+    }
+
+    // Views are independent, and a big asset has one per attribute stream so there's enough of them to go around
+    std::vector<uint8_t> succeeded(views.size(), 0);
+    auto decode = [&](uint32_t i) {
+        succeeded[i] = DecompressBufferView(views[i]) ? 1 : 0;
+    };
+    if (parallel) {
+        JobSystem::ParallelFor(static_cast<uint32_t>(views.size()), decode);
+    } else {
+        for (uint32_t i = 0; i < views.size(); i++) {
+            decode(i);
+        }
+    }
+
+    for (size_t i = 0; i < views.size(); i++) {
+        if (!succeeded[i]) {
+            LOG_ERROR("Failed to decode meshopt compressed buffer view {}", views[i]->name ? views[i]->name : "<unnamed>");
+        }
+        ASSERT(succeeded[i], "Corrupt EXT_meshopt_compression buffer view!");
+    }
+    return static_cast<uint32_t>(views.size());
+}
@@ -0,0 +1,44 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-19 11:06:52
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <cgltf.h>
+
+/*
+    Decoder for EXT_meshopt_compression buffer views, written against the bitstream described in the extension spec:
+        - ATTRIBUTES (0xA0): per byte lane zigzag deltas, packed in 16 byte groups of 0/2/4/8 bits
+        - TRIANGLES (0xE0/0xE1): edge/vertex FIFO codec, vbyte deltas for free indices
+        - INDICES (0xD0/0xD1): two baseline vbyte delta sequence
+    plus the OCTAHEDRAL, QUATERNION and EXPONENTIAL filters applied after ATTRIBUTES.
+    Decoded views replace buffer_view->data, which is what cgltf_buffer_view_data (and so AccessorDecoder) reads, and is freed by cgltf_free.
+    Quantized accessors (KHR_mesh_quantization) need nothing from here, AccessorDecoder reads their integer components directly.
+*/
+
+enum class MeshoptFilter : uint32_t
+{
+    None,
+    Octahedral,
+    Quaternion,
+    Exponential
+};
+
+class MeshoptDecoder
+{
+public:
+    /// @note(ame): all decoders return false on malformed or truncated streams, dst contents are undefined in that case.
+    static bool DecodeVertexBuffer(void* dst, size_t count, size_t stride, const uint8_t* src, size_t size);
+    /// @note(ame): indexSize is 2 or 4.
+    static bool DecodeIndexBuffer(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t size);
+    static bool DecodeIndexSequence(void* dst, size_t count, size_t indexSize, const uint8_t* src, size_t size);
+
+    /// @note(ame): in place, data holds count elements of stride bytes.
+    static void ApplyFilter(void* data, size_t count, size_t stride, MeshoptFilter filter);
+
+    /// @note(ame): decodes every compressed buffer view of data, one job per view. Returns the number of views decoded, asserts on corrupt streams.
+    static uint32_t DecompressBufferViews(cgltf_data* data, bool parallel);
+};
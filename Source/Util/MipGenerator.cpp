@@ -0,0 +1,329 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-23 09:58:14
+//
+
+#include "MipGenerator.hpp"
+#include "JobSystem.hpp"
+#include "LinearArena.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define MIP_GENERATOR_SSE2
+#endif
+
+/// @note(ame): levels with fewer texels than this are filtered on the calling thread, the job overhead isn't worth it.
+#define MIP_PARALLEL_MIN_TEXELS (256 * 256)
+#define MIP_ROWS_PER_JOB 16
+#define SRGB_ENCODE_BUCKETS 1024
+
+struct SRGBTables
+{
+    float Decode[256];
+    /// @note(ame): Thresholds[v] is the linear value halfway between the sRGB codes v - 1 and v, padded with -/+FLT_MAX.
+    float Thresholds[257];
+    /// @note(ame): code of bucket / SRGB_ENCODE_BUCKETS, where the threshold walk starts.
+    uint8_t Buckets[SRGB_ENCODE_BUCKETS + 1];
+};
+
+/// @note(ame): taps of one destination texel along one axis.
+struct MipTaps
+{
+    uint32_t First;
+    uint32_t Count;
+    float Weights[3];
+};
+
+static double SRGBToLinear(double value)
+{
+    return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+static const SRGBTables& GetSRGBTables()
+{
+    static const SRGBTables tables = [] {
+        SRGBTables result;
+        for (uint32_t v = 0; v < 256; v++) {
+            result.Decode[v] = static_cast<float>(SRGBToLinear(v / 255.0));
+        }
+
+        result.Thresholds[0] = -FLT_MAX;
+        for (uint32_t v = 1; v < 256; v++) {
+            result.Thresholds[v] = static_cast<float>(SRGBToLinear((v - 0.5) / 255.0));
+        }
+        result.Thresholds[256] = FLT_MAX;
+
+        uint32_t code = 0;
+        for (uint32_t bucket = 0; bucket <= SRGB_ENCODE_BUCKETS; bucket++) {
+            float value = static_cast<float>(bucket) / SRGB_ENCODE_BUCKETS;
+            while (result.Thresholds[code + 1] <= value) {
+                code++;
+            }
+            result.Buckets[bucket] = static_cast<uint8_t>(code);
+        }
+        return result;
+    }();
+    return tables;
+}
+
+static uint8_t EncodeLinear(float value)
+{
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+static uint8_t EncodeSRGB(float value, const SRGBTables& tables)
+{
+    // Same as rounding the sRGB curve: the code is the last threshold at or below the value
+    value = std::clamp(value, 0.0f, 1.0f);
+    uint32_t code = tables.Buckets[static_cast<uint32_t>(value * SRGB_ENCODE_BUCKETS)];
+    while (tables.Thresholds[code + 1] <= value) {
+        code++;
+    }
+    return static_cast<uint8_t>(code);
+}
+
+static void DecodeTexels(const uint8_t* src, size_t count, float* dst, MipFilter filter)
+{
+    switch (filter) {
+        case MipFilter::Linear: {
+            size_t i = 0;
+#ifdef MIP_GENERATOR_SSE2
+            const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 4 <= count; i += 4) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+                __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+                _mm_store_ps(dst + i * 4 + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+                _mm_store_ps(dst + i * 4 + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+                _mm_store_ps(dst + i * 4 + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+                _mm_store_ps(dst + i * 4 + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+            }
+#endif
+            for (i *= 4; i < count * 4; i++) {
+                dst[i] = src[i] / 255.0f;
+            }
+            break;
+        }
+        case MipFilter::SRGB: {
+            const SRGBTables& tables = GetSRGBTables();
+            for (size_t i = 0; i < count; i++) {
+                dst[i * 4 + 0] = tables.Decode[src[i * 4 + 0]];
+                dst[i * 4 + 1] = tables.Decode[src[i * 4 + 1]];
+                dst[i * 4 + 2] = tables.Decode[src[i * 4 + 2]];
+                dst[i * 4 + 3] = src[i * 4 + 3] / 255.0f;
+            }
+            break;
+        }
+        case MipFilter::Normal: {
+            for (size_t i = 0; i < count; i++) {
+                dst[i * 4 + 0] = src[i * 4 + 0] / 127.5f - 1.0f;
+                dst[i * 4 + 1] = src[i * 4 + 1] / 127.5f - 1.0f;
+                dst[i * 4 + 2] = src[i * 4 + 2] / 127.5f - 1.0f;
+                dst[i * 4 + 3] = src[i * 4 + 3] / 255.0f;
+            }
+            break;
+        }
+    }
+}
+
+static void EncodeTexels(const float* src, size_t count, uint8_t* dst, MipFilter filter)
+{
+    switch (filter) {
+        case MipFilter::Linear: {
+            size_t i = 0;
+#ifdef MIP_GENERATOR_SSE2
+            const __m128 scale = _mm_set1_ps(255.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+            for (; i + 4 <= count; i += 4) {
+                __m128i a = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_load_ps(src + i * 4 + 0), zero), one), scale), half));
+                __m128i b = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_load_ps(src + i * 4 + 4), zero), one), scale), half));
+                __m128i c = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_load_ps(src + i * 4 + 8), zero), one), scale), half));
+                __m128i d = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_load_ps(src + i * 4 + 12), zero), one), scale), half));
+                __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), bytes);
+            }
+#endif
+            for (i *= 4; i < count * 4; i++) {
+                dst[i] = EncodeLinear(src[i]);
+            }
+            break;
+        }
+        case MipFilter::SRGB: {
+            const SRGBTables& tables = GetSRGBTables();
+            for (size_t i = 0; i < count; i++) {
+                dst[i * 4 + 0] = EncodeSRGB(src[i * 4 + 0], tables);
+                dst[i * 4 + 1] = EncodeSRGB(src[i * 4 + 1], tables);
+                dst[i * 4 + 2] = EncodeSRGB(src[i * 4 + 2], tables);
+                dst[i * 4 + 3] = EncodeLinear(src[i * 4 + 3]);
+            }
+            break;
+        }
+        case MipFilter::Normal: {
+            for (size_t i = 0; i < count; i++) {
+                glm::vec3 normal(src[i * 4 + 0], src[i * 4 + 1], src[i * 4 + 2]);
+                float length = glm::length(normal);
+                // Opposing normals can cancel out, flat is the least wrong answer then
+                normal = length > 1e-6f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+
+                dst[i * 4 + 0] = EncodeLinear(normal.x * 0.5f + 0.5f);
+                dst[i * 4 + 1] = EncodeLinear(normal.y * 0.5f + 0.5f);
+                dst[i * 4 + 2] = EncodeLinear(normal.z * 0.5f + 0.5f);
+                dst[i * 4 + 3] = EncodeLinear(src[i * 4 + 3]);
+            }
+            break;
+        }
+    }
+}
+
+static void ComputeTaps(uint32_t srcSize, uint32_t dstSize, MipTaps* taps)
+{
+    for (uint32_t i = 0; i < dstSize; i++) {
+        MipTaps& tap = taps[i];
+        if (srcSize == 1) {
+            tap = { 0, 1, { 1.0f, 0.0f, 0.0f } };
+        } else if (srcSize % 2 == 0) {
+            tap = { i * 2, 2, { 0.5f, 0.5f, 0.0f } };
+        } else {
+            // 2n + 1 texels into n: every source texel ends up with a total weight of n / (2n + 1)
+            float inverse = 1.0f / srcSize;
+            tap = { i * 2, 3, { (dstSize - i) * inverse, dstSize * inverse, (i + 1) * inverse } };
+        }
+    }
+}
+
+static void FilterRows(const float* src, uint32_t srcWidth, float* dst, uint32_t dstWidth, const MipTaps* xTaps, const MipTaps* yTaps, uint32_t rowBegin, uint32_t rowEnd, bool box)
+{
+    for (uint32_t y = rowBegin; y < rowEnd; y++) {
+        float* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+
+        // Even sizes on both axes, the common case: plain 2x2 average
+        if (box) {
+            const float* row0 = src + static_cast<size_t>(y * 2) * srcWidth * 4;
+            const float* row1 = row0 + static_cast<size_t>(srcWidth) * 4;
+            for (uint32_t x = 0; x < dstWidth; x++) {
+#ifdef MIP_GENERATOR_SSE2
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_load_ps(row0 + x * 8), _mm_load_ps(row0 + x * 8 + 4)),
+                                        _mm_add_ps(_mm_load_ps(row1 + x * 8), _mm_load_ps(row1 + x * 8 + 4)));
+                _mm_store_ps(out + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+                for (uint32_t c = 0; c < 4; c++) {
+                    out[x * 4 + c] = (row0[x * 8 + c] + row0[x * 8 + 4 + c] + row1[x * 8 + c] + row1[x * 8 + 4 + c]) * 0.25f;
+                }
+#endif
+            }
+            continue;
+        }
+
+        const MipTaps& yTap = yTaps[y];
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            const MipTaps& xTap = xTaps[x];
+#ifdef MIP_GENERATOR_SSE2
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t j = 0; j < yTap.Count; j++) {
+                const float* row = src + static_cast<size_t>(yTap.First + j) * srcWidth * 4 + xTap.First * 4;
+                __m128 rowSum = _mm_setzero_ps();
+                for (uint32_t i = 0; i < xTap.Count; i++) {
+                    rowSum = _mm_add_ps(rowSum, _mm_mul_ps(_mm_load_ps(row + i * 4), _mm_set1_ps(xTap.Weights[i])));
+                }
+                sum = _mm_add_ps(sum, _mm_mul_ps(rowSum, _mm_set1_ps(yTap.Weights[j])));
+            }
+            _mm_store_ps(out + x * 4, sum);
+#else
+            float sum[4] = {};
+            for (uint32_t j = 0; j < yTap.Count; j++) {
+                const float* row = src + static_cast<size_t>(yTap.First + j) * srcWidth * 4 + xTap.First * 4;
+                float rowSum[4] = {};
+                for (uint32_t i = 0; i < xTap.Count; i++) {
+                    for (uint32_t c = 0; c < 4; c++) {
+                        rowSum[c] += row[i * 4 + c] * xTap.Weights[i];
+                    }
+                }
+                for (uint32_t c = 0; c < 4; c++) {
+                    sum[c] += rowSum[c] * yTap.Weights[j];
+                }
+            }
+            std::copy(sum, sum + 4, out + x * 4);
+#endif
+        }
+    }
+}
+
+uint32_t MipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+        levels++;
+    }
+    return levels;
+}
+
+size_t MipChainSize(uint32_t width, uint32_t height, uint32_t levels)
+{
+    size_t size = 0;
+    for (uint32_t level = 0; level < levels; level++) {
+        size += static_cast<size_t>(width) * height * 4;
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    return size;
+}
+
+void GenerateMipChain(std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, MipFilter filter, bool parallel)
+{
+    ASSERT(pixels.size() >= static_cast<size_t>(width) * height * 4, "Mip chain source is smaller than its first level!");
+
+    uint32_t levels = MipLevelCount(width, height);
+    pixels.resize(MipChainSize(width, height, levels));
+    if (levels == 1) {
+        return;
+    }
+
+    // Ping-pong between the full level and one at most half its size, levels after the first fit in either
+    ArenaScope scope;
+    size_t texels = static_cast<size_t>(width) * height;
+    float* current = scope.Arena.Allocate<float>(texels * 4);
+    float* next = scope.Arena.Allocate<float>((texels / 2 + 1) * 4);
+    MipTaps* xTaps = scope.Arena.Allocate<MipTaps>(width / 2 + 1);
+    MipTaps* yTaps = scope.Arena.Allocate<MipTaps>(height / 2 + 1);
+
+    DecodeTexels(pixels.data(), texels, current, filter);
+
+    uint8_t* out = pixels.data() + texels * 4;
+    uint32_t srcWidth = width;
+    uint32_t srcHeight = height;
+    for (uint32_t level = 1; level < levels; level++) {
+        uint32_t dstWidth = std::max(srcWidth / 2, 1u);
+        uint32_t dstHeight = std::max(srcHeight / 2, 1u);
+        bool box = srcWidth % 2 == 0 && srcHeight % 2 == 0;
+        ComputeTaps(srcWidth, dstWidth, xTaps);
+        ComputeTaps(srcHeight, dstHeight, yTaps);
+
+        auto process = [&](uint32_t rowBegin, uint32_t rowEnd) {
+            FilterRows(current, srcWidth, next, dstWidth, xTaps, yTaps, rowBegin, rowEnd, box);
+
+            size_t offset = static_cast<size_t>(rowBegin) * dstWidth;
+            EncodeTexels(next + offset * 4, static_cast<size_t>(rowEnd - rowBegin) * dstWidth, out + offset * 4, filter);
+        };
+
+        if (parallel && static_cast<size_t>(dstWidth) * dstHeight >= MIP_PARALLEL_MIN_TEXELS) {
+            uint32_t chunks = (dstHeight + MIP_ROWS_PER_JOB - 1) / MIP_ROWS_PER_JOB;
+            JobSystem::ParallelFor(chunks, [&](uint32_t chunk) {
+                process(chunk * MIP_ROWS_PER_JOB, std::min(dstHeight, (chunk + 1) * MIP_ROWS_PER_JOB));
+            });
+        } else {
+            process(0, dstHeight);
+        }
+
+        out += static_cast<size_t>(dstWidth) * dstHeight * 4;
+        std::swap(current, next);
+        srcWidth = dstWidth;
+        srcHeight = dstHeight;
+    }
+}
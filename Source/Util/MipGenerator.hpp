@@ -0,0 +1,35 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-23 09:37:52
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <vector>
+
+/*
+    CPU mip chains for RGBA8 textures, all the way down to 1x1.
+    Every level is filtered from the previous one kept in float, never from the 8 bit result, so the error doesn't compound:
+        - even sizes are a 2x2 box, odd sizes a 3 tap polyphase box so every source texel carries the same weight
+        - SRGB filters RGB in linear space and encodes back exactly (same result as rounding the sRGB curve), alpha stays linear
+        - Normal unpacks to [-1, 1], averages and renormalizes on encode, alpha stays linear
+    Levels are tightly packed one after the other, the layout Uploader::EnqueueTextureUpload takes for a texture with Levels > 1.
+*/
+
+enum class MipFilter : uint32_t
+{
+    Linear,
+    SRGB,
+    Normal
+};
+
+/// @note(ame): levels of the full chain, floor(log2(max(width, height))) + 1.
+uint32_t MipLevelCount(uint32_t width, uint32_t height);
+/// @note(ame): bytes of a tightly packed RGBA8 chain of levels.
+size_t MipChainSize(uint32_t width, uint32_t height, uint32_t levels);
+
+/// @note(ame): pixels holds level 0 and is grown to the full chain. Rows of big levels are split across the job system when parallel is set,
+/// safe to call from inside a job.
+void GenerateMipChain(std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, MipFilter filter, bool parallel = true);
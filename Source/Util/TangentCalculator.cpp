@@ -18,19 +18,21 @@ TangentCalculator::TangentCalculator()
     context.m_pInterface = &iface;
 }
 
-void TangentCalculator::Calculate(MeshData* data)
+bool TangentCalculator::Calculate(MeshData* data)
 {
     context.m_pUserData = data;
 
     if (genTangSpaceDefault(&context) == false) {
         LOG_ERROR("Failed to generate tangents!");
+        return false;
     }
+    return true;
 }
 
 int TangentCalculator::get_num_faces(const SMikkTSpaceContext *context)
 {
     MeshData *working_mesh = static_cast<MeshData*>(context->m_pUserData);
-    return working_mesh->Indices->size();
+    return static_cast<int>(working_mesh->IndexCount / 3);
 }
 
 int TangentCalculator::get_num_vertices_of_face(const SMikkTSpaceContext *context, const int iFace)
@@ -41,44 +43,36 @@ int TangentCalculator::get_num_vertices_of_face(const SMikkTSpaceContext *contex
 void TangentCalculator::get_position(const SMikkTSpaceContext *context, float *outpos, const int iFace, const int iVert)
 {
     MeshData *working_mesh = static_cast<MeshData*>(context->m_pUserData);
+    const glm::vec3& position = working_mesh->Vertices[get_vertex_index(context, iFace, iVert)].Position;
 
-    auto index = get_vertex_index(context, iFace, iVert);
-    auto vertex = working_mesh->Vertices->at(index);
-
-    outpos[0] = vertex.Position.x;
-    outpos[1] = vertex.Position.y;
-    outpos[2] = vertex.Position.z;
+    outpos[0] = position.x;
+    outpos[1] = position.y;
+    outpos[2] = position.z;
 }
 
 void TangentCalculator::get_normal(const SMikkTSpaceContext *context, float *outnormal, const int iFace, const int iVert)
 {
     MeshData *working_mesh = static_cast<MeshData*>(context->m_pUserData);
+    const glm::vec3& normal = working_mesh->Vertices[get_vertex_index(context, iFace, iVert)].Normal;
 
-    auto index = get_vertex_index(context, iFace, iVert);
-    auto vertex = working_mesh->Vertices->at(index);
-
-    outnormal[0] = vertex.Normal.x;
-    outnormal[1] = vertex.Normal.y;
-    outnormal[2] = vertex.Normal.z;
+    outnormal[0] = normal.x;
+    outnormal[1] = normal.y;
+    outnormal[2] = normal.z;
 }
 
 void TangentCalculator::get_tex_coords(const SMikkTSpaceContext *context, float *outuv, const int iFace, const int iVert)
 {
     MeshData *working_mesh = static_cast<MeshData*>(context->m_pUserData);
+    const glm::vec2& uv = working_mesh->Vertices[get_vertex_index(context, iFace, iVert)].UV;
 
-    auto index = get_vertex_index(context, iFace, iVert);
-    auto vertex = working_mesh->Vertices->at(index);
-
-    outuv[0] = vertex.UV.x;
-    outuv[1] = vertex.UV.y;
+    outuv[0] = uv.x;
+    outuv[1] = uv.y;
 }
 
 void TangentCalculator::set_tspace(const SMikkTSpaceContext * pContext, const float fvTangent[], const float fvBiTangent[], const float fMagS, const float fMagT, const tbool bIsOrientationPreserving, const int iFace, const int iVert)
 {
     MeshData *working_mesh = static_cast<MeshData*>(pContext->m_pUserData);
-
-    auto index = get_vertex_index(pContext, iFace, iVert);
-    auto& vertex = working_mesh->Vertices->at(index);
+    Vertex& vertex = working_mesh->Vertices[get_vertex_index(pContext, iFace, iVert)];
 
     vertex.Tangent.x = fvTangent[0];
     vertex.Tangent.y = fvTangent[1];
@@ -91,10 +85,6 @@ void TangentCalculator::set_tspace(const SMikkTSpaceContext * pContext, const fl
 int TangentCalculator::get_vertex_index(const SMikkTSpaceContext *context, int iFace, int iVert) {
     MeshData *working_mesh = static_cast<MeshData*>(context->m_pUserData);
 
-    auto face_size = get_num_vertices_of_face(context, iFace);
-
-    auto indices_index = (iFace * face_size) + iVert;
-
-    int index = working_mesh->Indices->at(indices_index);
-    return index;
+    // Triangles only, see get_num_vertices_of_face
+    return static_cast<int>(working_mesh->Indices[iFace * 3 + iVert]);
 }
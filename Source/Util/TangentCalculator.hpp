@@ -18,18 +18,26 @@ struct Vertex
     glm::vec3 Bitangent;
 };
 
+/// @note(ame): plain pointers so the callbacks index straight into the arrays, no copies and no bounds checks.
 struct MeshData
 {
-    std::vector<Vertex>* Vertices;
-    std::vector<uint32_t>* Indices;
+    Vertex* Vertices;
+    const uint32_t* Indices;
+    size_t VertexCount;
+    size_t IndexCount;
 };
 
+/*
+    MikkTSpace wrapper. Each calculator owns its context and touches nothing shared,
+    so independent primitives can run concurrently with one calculator each.
+*/
 class TangentCalculator
 {
 public:
     TangentCalculator();
 
-    void Calculate(MeshData* data);
+    /// @note(ame): writes Tangent/Bitangent of every vertex referenced by data->Indices, false if mikktspace failed.
+    bool Calculate(MeshData* data);
 private:
     SMikkTSpaceInterface iface{};
     SMikkTSpaceContext context{};
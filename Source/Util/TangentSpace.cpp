@@ -0,0 +1,365 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-18 10:05:12
+//
+
+#include "TangentSpace.hpp"
+#include "JobSystem.hpp"
+#include "LinearArena.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define TANGENT_SPACE_SSE2
+#endif
+
+/// @note(ame): every job re-reads the whole index buffer, don't split below this many vertices per job.
+#define TANGENT_MIN_JOB_VERTICES 32768
+
+static_assert(sizeof(Vertex) == 14 * sizeof(float), "TangentSpace gathers Vertex as a flat float array");
+
+/// @note(ame): SoA over 4 vertices: the finalize pass loads whole registers, a scatter touches at most two cache lines.
+struct alignas(16) TangentBlock
+{
+    float TX[4];
+    float TY[4];
+    float TZ[4];
+    float BX[4];
+    float BY[4];
+    float BZ[4];
+};
+
+static inline bool Owns(uint32_t index, uint32_t first, uint32_t last)
+{
+    return index - first < last - first;
+}
+
+static inline void Scatter(TangentBlock* blocks, uint32_t index, const float tangent[3], const float bitangent[3])
+{
+    TangentBlock& block = blocks[index / 4];
+    uint32_t lane = index % 4;
+    block.TX[lane] += tangent[0];
+    block.TY[lane] += tangent[1];
+    block.TZ[lane] += tangent[2];
+    block.BX[lane] += bitangent[0];
+    block.BY[lane] += bitangent[1];
+    block.BZ[lane] += bitangent[2];
+}
+
+/// @note(ame): same expressions as ComputeReference, the SIMD lanes below mirror them one for one.
+static void AccumulateTriangle(const Vertex* vertices, const uint32_t* triangle, uint32_t first, uint32_t last, TangentBlock* blocks)
+{
+    const Vertex& v0 = vertices[triangle[0]];
+    const Vertex& v1 = vertices[triangle[1]];
+    const Vertex& v2 = vertices[triangle[2]];
+
+    glm::vec3 edge1 = v1.Position - v0.Position;
+    glm::vec3 edge2 = v2.Position - v0.Position;
+
+    float u1 = v1.UV.x - v0.UV.x;
+    float v1_ = v1.UV.y - v0.UV.y;
+    float u2 = v2.UV.x - v0.UV.x;
+    float v2_ = v2.UV.y - v0.UV.y;
+
+    float det = (u1 * v2_ - u2 * v1_);
+    float invDet = (det != 0.0f) ? 1.0f / det : 0.0f;
+
+    glm::vec3 tangent = (edge1 * v2_ - edge2 * v1_) * invDet;
+    glm::vec3 bitangent = (edge2 * u1 - edge1 * u2) * invDet;
+
+    for (int k = 0; k < 3; k++) {
+        if (Owns(triangle[k], first, last)) {
+            Scatter(blocks, triangle[k], &tangent.x, &bitangent.x);
+        }
+    }
+}
+
+#ifdef TANGENT_SPACE_SSE2
+/// @note(ame): component of corner k for the 4 triangles whose interleaved indices are in corners.
+static inline __m128 GatherCorner(const float* base, const uint32_t* corners, uint32_t k, size_t component)
+{
+    const size_t stride = sizeof(Vertex) / sizeof(float);
+    return _mm_setr_ps(
+        base[corners[0 + k] * stride + component],
+        base[corners[3 + k] * stride + component],
+        base[corners[6 + k] * stride + component],
+        base[corners[9 + k] * stride + component]
+    );
+}
+
+static inline int OwnedCorners(__m128i indices, __m128i rangeFirst, __m128i rangeSize, __m128i bias)
+{
+    // Unsigned (index - first) < (last - first) through the signed compare
+    __m128i owned = _mm_cmplt_epi32(_mm_xor_si128(_mm_sub_epi32(indices, rangeFirst), bias), rangeSize);
+    return _mm_movemask_ps(_mm_castsi128_ps(owned));
+}
+
+/// @note(ame): one lane per triangle, corners holds the 4 triangles' indices interleaved like the index buffer.
+static void AccumulateBatch(const Vertex* vertices, const uint32_t* corners, uint32_t first, uint32_t last, TangentBlock* blocks)
+{
+    const float* base = reinterpret_cast<const float*>(vertices);
+    const size_t px = offsetof(Vertex, Position) / sizeof(float);
+    const size_t uv = offsetof(Vertex, UV) / sizeof(float);
+
+    __m128 p0x = GatherCorner(base, corners, 0, px + 0);
+    __m128 p0y = GatherCorner(base, corners, 0, px + 1);
+    __m128 p0z = GatherCorner(base, corners, 0, px + 2);
+
+    __m128 e1x = _mm_sub_ps(GatherCorner(base, corners, 1, px + 0), p0x);
+    __m128 e1y = _mm_sub_ps(GatherCorner(base, corners, 1, px + 1), p0y);
+    __m128 e1z = _mm_sub_ps(GatherCorner(base, corners, 1, px + 2), p0z);
+    __m128 e2x = _mm_sub_ps(GatherCorner(base, corners, 2, px + 0), p0x);
+    __m128 e2y = _mm_sub_ps(GatherCorner(base, corners, 2, px + 1), p0y);
+    __m128 e2z = _mm_sub_ps(GatherCorner(base, corners, 2, px + 2), p0z);
+
+    __m128 uv0x = GatherCorner(base, corners, 0, uv + 0);
+    __m128 uv0y = GatherCorner(base, corners, 0, uv + 1);
+    __m128 u1 = _mm_sub_ps(GatherCorner(base, corners, 1, uv + 0), uv0x);
+    __m128 v1 = _mm_sub_ps(GatherCorner(base, corners, 1, uv + 1), uv0y);
+    __m128 u2 = _mm_sub_ps(GatherCorner(base, corners, 2, uv + 0), uv0x);
+    __m128 v2 = _mm_sub_ps(GatherCorner(base, corners, 2, uv + 1), uv0y);
+
+    // Degenerate UVs: 1/0 is masked back to 0, NaN stays NaN like in the scalar path
+    __m128 det = _mm_sub_ps(_mm_mul_ps(u1, v2), _mm_mul_ps(u2, v1));
+    __m128 invDet = _mm_and_ps(_mm_cmpneq_ps(det, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.0f), det));
+
+    alignas(16) float lanes[6][4];
+    _mm_store_ps(lanes[0], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e1x, v2), _mm_mul_ps(e2x, v1)), invDet));
+    _mm_store_ps(lanes[1], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e1y, v2), _mm_mul_ps(e2y, v1)), invDet));
+    _mm_store_ps(lanes[2], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e1z, v2), _mm_mul_ps(e2z, v1)), invDet));
+    _mm_store_ps(lanes[3], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e2x, u1), _mm_mul_ps(e1x, u2)), invDet));
+    _mm_store_ps(lanes[4], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e2y, u1), _mm_mul_ps(e1y, u2)), invDet));
+    _mm_store_ps(lanes[5], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e2z, u1), _mm_mul_ps(e1z, u2)), invDet));
+
+    // Scatter in triangle then corner order, which keeps the summation order of the reference
+    for (uint32_t lane = 0; lane < 4; lane++) {
+        float tangent[3] = { lanes[0][lane], lanes[1][lane], lanes[2][lane] };
+        float bitangent[3] = { lanes[3][lane], lanes[4][lane], lanes[5][lane] };
+        for (uint32_t k = 0; k < 3; k++) {
+            uint32_t index = corners[lane * 3 + k];
+            if (Owns(index, first, last)) {
+                Scatter(blocks, index, tangent, bitangent);
+            }
+        }
+    }
+}
+#endif
+
+static void AccumulateRange(const Vertex* vertices, const uint32_t* indices, size_t triangleCount, uint32_t first, uint32_t last, TangentBlock* blocks)
+{
+    size_t t = 0;
+#ifdef TANGENT_SPACE_SSE2
+    const __m128i bias = _mm_set1_epi32(INT32_MIN);
+    const __m128i rangeFirst = _mm_set1_epi32(static_cast<int>(first));
+    const __m128i rangeSize = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(last - first)), bias);
+
+    // A lone job owns every vertex: the index buffer already is the lanes, no range tests or queueing
+    if (first == 0 && last == UINT32_MAX) {
+        for (; t + 4 <= triangleCount; t += 4) {
+            AccumulateBatch(vertices, indices + t * 3, first, last, blocks);
+        }
+        for (; t < triangleCount; t++) {
+            AccumulateTriangle(vertices, indices + t * 3, first, last, blocks);
+        }
+        return;
+    }
+
+    // Triangles touching our range are queued until 4 of them fill the lanes, the others are never gathered
+    uint32_t batch[12];
+    uint32_t batchCount = 0;
+    for (; t + 4 <= triangleCount; t += 4) {
+        // 4 triangles = 12 interleaved indices = 3 loads, one bit per corner
+        const __m128i* src = reinterpret_cast<const __m128i*>(indices + t * 3);
+        int owned = OwnedCorners(_mm_loadu_si128(src + 0), rangeFirst, rangeSize, bias);
+        owned |= OwnedCorners(_mm_loadu_si128(src + 1), rangeFirst, rangeSize, bias) << 4;
+        owned |= OwnedCorners(_mm_loadu_si128(src + 2), rangeFirst, rangeSize, bias) << 8;
+        if (owned == 0) {
+            continue;
+        }
+
+        for (uint32_t k = 0; k < 4; k++) {
+            if ((owned >> (k * 3)) & 7) {
+                std::copy(indices + (t + k) * 3, indices + (t + k) * 3 + 3, batch + batchCount * 3);
+                if (++batchCount == 4) {
+                    AccumulateBatch(vertices, batch, first, last, blocks);
+                    batchCount = 0;
+                }
+            }
+        }
+    }
+    for (uint32_t i = 0; i < batchCount; i++) {
+        AccumulateTriangle(vertices, batch + i * 3, first, last, blocks);
+    }
+#endif
+    for (; t < triangleCount; t++) {
+        AccumulateTriangle(vertices, indices + t * 3, first, last, blocks);
+    }
+}
+
+static void FinalizeVertex(Vertex& vertex, glm::vec3 t, glm::vec3 expectedB)
+{
+    glm::vec3 n = vertex.Normal;
+
+    t = glm::normalize(t - glm::dot(n, t) * n);
+    glm::vec3 b = glm::cross(n, t);
+    float handedness = (glm::dot(b, expectedB) < 0.0f) ? -1.0f : 1.0f;
+
+    vertex.Tangent = t * handedness;
+    vertex.Bitangent = b * handedness;
+}
+
+static void FinalizeRange(Vertex* vertices, uint32_t first, uint32_t last, TangentBlock* blocks)
+{
+    // first is always a multiple of 4, see Compute
+    uint32_t i = first;
+#ifdef TANGENT_SPACE_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    alignas(16) float lanes[6][4];
+    for (; i + 4 <= last; i += 4) {
+        Vertex* v = vertices + i;
+        __m128 nx = _mm_setr_ps(v[0].Normal.x, v[1].Normal.x, v[2].Normal.x, v[3].Normal.x);
+        __m128 ny = _mm_setr_ps(v[0].Normal.y, v[1].Normal.y, v[2].Normal.y, v[3].Normal.y);
+        __m128 nz = _mm_setr_ps(v[0].Normal.z, v[1].Normal.z, v[2].Normal.z, v[3].Normal.z);
+        const TangentBlock& block = blocks[i / 4];
+        __m128 tx = _mm_load_ps(block.TX);
+        __m128 ty = _mm_load_ps(block.TY);
+        __m128 tz = _mm_load_ps(block.TZ);
+
+        // Gram-Schmidt, normalize as glm does (multiply by 1 / sqrt, not rsqrt)
+        __m128 nt = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, tx), _mm_mul_ps(ny, ty)), _mm_mul_ps(nz, tz));
+        tx = _mm_sub_ps(tx, _mm_mul_ps(nt, nx));
+        ty = _mm_sub_ps(ty, _mm_mul_ps(nt, ny));
+        tz = _mm_sub_ps(tz, _mm_mul_ps(nt, nz));
+        __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz));
+        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(length2));
+        tx = _mm_mul_ps(tx, invLength);
+        ty = _mm_mul_ps(ty, invLength);
+        tz = _mm_mul_ps(tz, invLength);
+
+        __m128 bx = _mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(ty, nz));
+        __m128 by = _mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(tz, nx));
+        __m128 bz = _mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(tx, ny));
+
+        __m128 side = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx, _mm_load_ps(block.BX)), _mm_mul_ps(by, _mm_load_ps(block.BY))), _mm_mul_ps(bz, _mm_load_ps(block.BZ)));
+        __m128 handedness = _mm_or_ps(one, _mm_and_ps(_mm_cmplt_ps(side, zero), signBit));
+
+        _mm_store_ps(lanes[0], _mm_mul_ps(tx, handedness));
+        _mm_store_ps(lanes[1], _mm_mul_ps(ty, handedness));
+        _mm_store_ps(lanes[2], _mm_mul_ps(tz, handedness));
+        _mm_store_ps(lanes[3], _mm_mul_ps(bx, handedness));
+        _mm_store_ps(lanes[4], _mm_mul_ps(by, handedness));
+        _mm_store_ps(lanes[5], _mm_mul_ps(bz, handedness));
+        for (uint32_t lane = 0; lane < 4; lane++) {
+            v[lane].Tangent = glm::vec3(lanes[0][lane], lanes[1][lane], lanes[2][lane]);
+            v[lane].Bitangent = glm::vec3(lanes[3][lane], lanes[4][lane], lanes[5][lane]);
+        }
+    }
+#endif
+    for (; i < last; i++) {
+        const TangentBlock& block = blocks[i / 4];
+        uint32_t lane = i % 4;
+        FinalizeVertex(vertices[i], glm::vec3(block.TX[lane], block.TY[lane], block.TZ[lane]), glm::vec3(block.BX[lane], block.BY[lane], block.BZ[lane]));
+    }
+}
+
+void TangentSpace::Compute(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+{
+    if (vertexCount == 0) {
+        return;
+    }
+
+    // Left uninitialized, each job clears the blocks it owns
+    ArenaScope scope;
+    size_t blockCount = (vertexCount + 3) / 4;
+    TangentBlock* blocks = scope.Arena.Allocate<TangentBlock>(blockCount);
+
+    size_t triangleCount = indexCount / 3;
+    // Every job re-reads all the indices, more jobs than cores only multiplies that: one job when there's nothing to run beside it
+    uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    uint32_t maxJobs = std::min(JobSystem::GetThreadCount() + 1, hardwareThreads);
+    uint32_t jobCount = static_cast<uint32_t>(std::clamp<size_t>(vertexCount / TANGENT_MIN_JOB_VERTICES, 1, maxJobs));
+    JobSystem::ParallelFor(jobCount, [&](uint32_t job) {
+        // Ranges split on block boundaries so no block is shared between two jobs
+        size_t firstBlock = blockCount * job / jobCount;
+        size_t lastBlock = blockCount * (job + 1) / jobCount;
+        uint32_t first = static_cast<uint32_t>(firstBlock * 4);
+        uint32_t last = static_cast<uint32_t>(std::min(lastBlock * 4, vertexCount));
+
+        std::fill(blocks + firstBlock, blocks + lastBlock, TangentBlock {});
+        AccumulateRange(vertices, indices, triangleCount, first, jobCount == 1 ? UINT32_MAX : last, blocks);
+        FinalizeRange(vertices, first, last, blocks);
+    });
+}
+
+void TangentSpace::ComputeReference(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+{
+    std::vector<glm::vec3> accumulatedTangents(vertices.size(), {0, 0, 0});
+    std::vector<glm::vec3> accumulatedBitangents(vertices.size(), {0, 0, 0});
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        uint32_t i0 = indices[i];
+        uint32_t i1 = indices[i + 1];
+        uint32_t i2 = indices[i + 2];
+
+        const Vertex& v0 = vertices[i0];
+        const Vertex& v1 = vertices[i1];
+        const Vertex& v2 = vertices[i2];
+
+        glm::vec3 p0 = v0.Position;
+        glm::vec3 p1 = v1.Position;
+        glm::vec3 p2 = v2.Position;
+
+        glm::vec2 uv0 = v0.UV;
+        glm::vec2 uv1 = v1.UV;
+        glm::vec2 uv2 = v2.UV;
+
+        glm::vec3 edge1 = p1 - p0;
+        glm::vec3 edge2 = p2 - p0;
+
+        float u1 = uv1.x - uv0.x;
+        float v1_ = uv1.y - uv0.y;
+        float u2 = uv2.x - uv0.x;
+        float v2_ = uv2.y - uv0.y;
+
+        float det = (u1 * v2_ - u2 * v1_);
+        float invDet = (det != 0.0f) ? 1.0f / det : 0.0f;
+
+        glm::vec3 tangent = (edge1 * v2_ - edge2 * v1_) * invDet;
+        glm::vec3 bitangent = (edge2 * u1 - edge1 * u2) * invDet;
+
+        // Accumulate tangents and bitangents
+        accumulatedTangents[i0] += tangent;
+        accumulatedTangents[i1] += tangent;
+        accumulatedTangents[i2] += tangent;
+
+        accumulatedBitangents[i0] += bitangent;
+        accumulatedBitangents[i1] += bitangent;
+        accumulatedBitangents[i2] += bitangent;
+    }
+
+    // Normalize and orthogonalize
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        glm::vec3 n = vertices[i].Normal;
+        glm::vec3 t = accumulatedTangents[i];
+
+        // Gram-Schmidt orthogonalization
+        t = glm::normalize(t - glm::dot(n, t) * n);
+
+        // Compute handedness via bitangent
+        glm::vec3 b = glm::cross(n, t);
+        glm::vec3 expectedB = accumulatedBitangents[i];
+
+        // If the bitangent is pointing in the wrong direction, flip the tangent
+        float handedness = (glm::dot(b, expectedB) < 0.0f) ? -1.0f : 1.0f;
+
+        // Store the tangent and bitangent (bitangent only if you need it separately)
+        vertices[i].Tangent = t * handedness;
+        vertices[i].Bitangent = glm::cross(n, t) * handedness; // Optional, for use in shaders
+    }
+}
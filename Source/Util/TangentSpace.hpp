@@ -0,0 +1,38 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-18 09:37:44
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "TangentCalculator.hpp"
+
+/*
+    Per-vertex tangent frames from accumulated per-triangle UV gradients, Gram-Schmidt'd against the vertex normal.
+    Compute is the fast path used at load:
+        - triangles go through 4-wide SSE2 lanes (scalar tail), vertices are gathered straight from the AoS buffer
+        - tangents/bitangents are accumulated into SoA float streams instead of two vec3 arrays
+        - the vertex range is split between jobs, each job walks every triangle but only scatters into the vertices it owns,
+          so no two jobs ever write the same accumulator and no atomics/merging are needed
+        - at most one job per hardware thread; a single job skips the range tests and feeds the index buffer straight to the lanes
+    Contributions land on each vertex in triangle order, the same order as ComputeReference.
+    ComputeReference is the original scalar routine, kept to check Compute against.
+*/
+
+enum class TangentMode : uint32_t
+{
+    /// @note(ame): TangentSpace::Compute, fast, accumulated UV gradients.
+    Accumulated,
+    /// @note(ame): TangentCalculator, MikkTSpace frames matching what most normal map bakers expect.
+    MikkTSpace
+};
+
+class TangentSpace
+{
+public:
+    static void Compute(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+
+    static void ComputeReference(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+};
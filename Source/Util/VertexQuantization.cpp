@@ -0,0 +1,165 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-14 18:31:09
+//
+
+#include "VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // NaN / Inf
+    if (((bits >> 23) & 0xFF) == 0xFF) {
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+    // Overflow -> Inf
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    // Denormal or zero
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // Round to nearest even, a mantissa carry correctly bumps the exponent
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return static_cast<uint16_t>(half);
+}
+
+float HalfToFloat(uint16_t value)
+{
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Renormalize denormals
+            exponent = 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            mantissa &= 0x3FF;
+            bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static inline uint32_t PackSnorm16(float value)
+{
+    float clamped = std::clamp(value, -1.0f, 1.0f);
+    return static_cast<uint32_t>(static_cast<int32_t>(std::round(clamped * 32767.0f))) & 0xFFFF;
+}
+
+static inline float UnpackSnorm16(uint32_t value)
+{
+    int16_t signedValue = static_cast<int16_t>(value & 0xFFFF);
+    return std::max(signedValue / 32767.0f, -1.0f);
+}
+
+uint32_t EncodeOctahedral(glm::vec3 direction)
+{
+    float sum = std::fabs(direction.x) + std::fabs(direction.y) + std::fabs(direction.z);
+    if (!(sum > 0.0f) || !std::isfinite(sum)) {
+        direction = glm::vec3(0.0f, 0.0f, 1.0f);
+        sum = 1.0f;
+    }
+
+    float x = direction.x / sum;
+    float y = direction.y / sum;
+    if (direction.z < 0.0f) {
+        float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+    return PackSnorm16(x) | (PackSnorm16(y) << 16);
+}
+
+glm::vec3 DecodeOctahedral(uint32_t encoded)
+{
+    float x = UnpackSnorm16(encoded);
+    float y = UnpackSnorm16(encoded >> 16);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+    float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    return glm::normalize(glm::vec3(x, y, z));
+}
+
+void ComputeBounds(const Vertex* vertices, size_t count, glm::vec3& min, glm::vec3& max)
+{
+    min = glm::vec3(FLT_MAX);
+    max = glm::vec3(-FLT_MAX);
+    for (size_t i = 0; i < count; i++) {
+        min = glm::min(min, vertices[i].Position);
+        max = glm::max(max, vertices[i].Position);
+    }
+    if (count == 0) {
+        min = max = glm::vec3(0.0f);
+    }
+}
+
+CompactAttributes EncodeAttributes(const VertexAttributes& attributes)
+{
+    // Bitangent is only ever +-cross(N, T), keep the sign
+    bool flipped = glm::dot(glm::cross(attributes.Normal, attributes.Tangent), attributes.Bitangent) < 0.0f;
+
+    CompactAttributes out;
+    out.Normal = EncodeOctahedral(attributes.Normal);
+    out.Tangent = EncodeOctahedral(attributes.Tangent);
+    out.UV = FloatToHalf(attributes.UV.x) | (static_cast<uint32_t>(FloatToHalf(attributes.UV.y)) << 16);
+    out.Flags = flipped ? 1u : 0u;
+    return out;
+}
+
+VertexAttributes DecodeAttributes(const CompactAttributes& attributes)
+{
+    VertexAttributes out;
+    out.Normal = DecodeOctahedral(attributes.Normal);
+    out.Tangent = DecodeOctahedral(attributes.Tangent);
+    out.UV = glm::vec2(HalfToFloat(attributes.UV & 0xFFFF), HalfToFloat(attributes.UV >> 16));
+
+    float sign = attributes.Flags & 1 ? -1.0f : 1.0f;
+    out.Bitangent = glm::cross(out.Normal, out.Tangent) * sign;
+    return out;
+}
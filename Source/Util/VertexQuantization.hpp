@@ -0,0 +1,40 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-14 18:22:51
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "VertexStreams.hpp"
+
+/*
+    Compact attribute layout, 16 bytes instead of the 44 of VertexAttributes:
+        - normal and tangent octahedral encoded as snorm16x2 (angular error under 0.05 degrees)
+        - UV as half2 (relative error <= 2^-11, keep UVs in a sane range)
+        - bitangent dropped, rebuilt as cross(normal, tangent) * sign, sign stored in bit 0 of Flags
+    Positions live in their own float3 stream (see VertexStreams.hpp) and are never quantized, the BLAS needs them as is.
+    Decoded by LoadVertex in Shaders/Raytrace.hlsl.
+*/
+
+struct CompactAttributes
+{
+    uint32_t Normal;
+    uint32_t Tangent;
+    uint32_t UV;
+    uint32_t Flags;
+};
+
+static_assert(sizeof(CompactAttributes) == 16, "CompactAttributes must match the HLSL layout");
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+uint32_t EncodeOctahedral(glm::vec3 direction);
+glm::vec3 DecodeOctahedral(uint32_t encoded);
+
+void ComputeBounds(const Vertex* vertices, size_t count, glm::vec3& min, glm::vec3& max);
+
+CompactAttributes EncodeAttributes(const VertexAttributes& attributes);
+VertexAttributes DecodeAttributes(const CompactAttributes& attributes);
@@ -0,0 +1,30 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-15 10:20:03
+//
+
+#include "VertexStreams.hpp"
+
+void SplitVertexStreams(const Vertex* vertices, size_t count, glm::vec3* positions, VertexAttributes* attributes)
+{
+    for (size_t i = 0; i < count; i++) {
+        const Vertex& vertex = vertices[i];
+
+        positions[i] = vertex.Position;
+        attributes[i].Normal = vertex.Normal;
+        attributes[i].UV = vertex.UV;
+        attributes[i].Tangent = vertex.Tangent;
+        attributes[i].Bitangent = vertex.Bitangent;
+    }
+}
+
+Vertex MergeVertexStreams(glm::vec3 position, const VertexAttributes& attributes)
+{
+    Vertex out;
+    out.Position = position;
+    out.Normal = attributes.Normal;
+    out.UV = attributes.UV;
+    out.Tangent = attributes.Tangent;
+    out.Bitangent = attributes.Bitangent;
+    return out;
+}
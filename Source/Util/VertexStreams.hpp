@@ -0,0 +1,30 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-15 10:12:44
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "TangentCalculator.hpp"
+
+/*
+    Vertices are uploaded as two streams:
+        - positions, tightly packed float3, the only thing the BLAS build and traversal read
+        - shading attributes (VertexAttributes or CompactAttributes), only fetched at hit time
+    Vertex stays the CPU-side interleaved layout used by decode, tangents and the cook.
+*/
+
+struct VertexAttributes
+{
+    glm::vec3 Normal;
+    glm::vec2 UV;
+    glm::vec3 Tangent;
+    glm::vec3 Bitangent;
+};
+
+static_assert(sizeof(VertexAttributes) == 44, "VertexAttributes must match the HLSL layout");
+
+void SplitVertexStreams(const Vertex* vertices, size_t count, glm::vec3* positions, VertexAttributes* attributes);
+Vertex MergeVertexStreams(glm::vec3 position, const VertexAttributes& attributes);
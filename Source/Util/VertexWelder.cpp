@@ -0,0 +1,136 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-16 09:47:55
+//
+
+#include "VertexWelder.hpp"
+#include "LinearArena.hpp"
+
+#include <cmath>
+#include <cstring>
+
+struct WeldKey
+{
+    uint32_t Values[8];
+    /// @note(ame): bit i set when Values[i] holds the float's bits instead of a cell index.
+    uint32_t Exact;
+
+    bool operator==(const WeldKey& other) const { return !memcmp(this, &other, sizeof(WeldKey)); }
+};
+
+/// @note(ame): past 2^24 cells adjacent floats are already further than epsilon apart, the float itself is the cell.
+#define WELD_MAX_CELL 16777216.0
+
+static inline uint32_t FloatBits(float value)
+{
+    // Treat -0 and +0 as the same value
+    if (value == 0.0f) {
+        return 0;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/// @note(ame): returns true when the component was keyed on its bits.
+static inline bool QuantizeComponent(float value, float epsilon, uint32_t& key)
+{
+    if (epsilon > 0.0f) {
+        // In double so large coordinates or tiny epsilons never overflow the int conversion
+        double cell = std::floor(static_cast<double>(value) / static_cast<double>(epsilon));
+        if (std::fabs(cell) < WELD_MAX_CELL) {
+            key = static_cast<uint32_t>(static_cast<int32_t>(cell));
+            return false;
+        }
+    }
+
+    key = FloatBits(value);
+    return true;
+}
+
+/// @note(ame): cheap multiply-xorshift mix, the keys are already well spread and this runs once per vertex.
+static inline uint64_t HashKey(const WeldKey& key)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ key.Exact;
+    for (int i = 0; i < 8; i += 2) {
+        uint64_t word = key.Values[i] | (static_cast<uint64_t>(key.Values[i + 1]) << 32);
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+static inline WeldKey MakeKey(const Vertex& vertex, const WeldOptions& options)
+{
+    const float components[8] = {
+        vertex.Position.x, vertex.Position.y, vertex.Position.z,
+        vertex.Normal.x, vertex.Normal.y, vertex.Normal.z,
+        vertex.UV.x, vertex.UV.y
+    };
+    const float epsilons[8] = {
+        options.PositionEpsilon, options.PositionEpsilon, options.PositionEpsilon,
+        options.NormalEpsilon, options.NormalEpsilon, options.NormalEpsilon,
+        options.UVEpsilon, options.UVEpsilon
+    };
+
+    WeldKey key;
+    key.Exact = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+        key.Exact |= static_cast<uint32_t>(QuantizeComponent(components[i], epsilons[i], key.Values[i])) << i;
+    }
+    return key;
+}
+
+WeldStats VertexWelder::Weld(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const WeldOptions& options)
+{
+    WeldStats stats;
+    stats.VerticesBefore = static_cast<uint32_t>(vertices.size());
+    stats.VerticesAfter = stats.VerticesBefore;
+    if (vertices.empty()) {
+        return stats;
+    }
+
+    // Power of two, at most half full
+    size_t capacity = 1;
+    while (capacity < vertices.size() * 2) {
+        capacity <<= 1;
+    }
+    // Each slot keeps the upper hash bits next to the vertex id, so most mismatches are rejected without touching keys
+    struct Slot
+    {
+        uint32_t Vertex;
+        uint32_t Tag;
+    };
+    ArenaScope scope;
+    Slot* table = scope.Arena.Allocate<Slot>(capacity, Slot{ UINT32_MAX, 0 });
+    WeldKey* keys = scope.Arena.Allocate<WeldKey>(vertices.size());
+    uint32_t* remap = scope.Arena.Allocate<uint32_t>(vertices.size());
+
+    uint32_t unique = 0;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        WeldKey key = MakeKey(vertices[i], options);
+        uint64_t hash = HashKey(key);
+        uint32_t tag = static_cast<uint32_t>(hash >> 32);
+
+        size_t slot = hash & (capacity - 1);
+        while (table[slot].Vertex != UINT32_MAX && !(table[slot].Tag == tag && keys[table[slot].Vertex] == key)) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+
+        if (table[slot].Vertex == UINT32_MAX) {
+            table[slot] = Slot{ unique, tag };
+            keys[unique] = key;
+            vertices[unique] = vertices[i];
+            unique++;
+        }
+        remap[i] = table[slot].Vertex;
+    }
+
+    for (uint32_t& index : indices) {
+        index = remap[index];
+    }
+    vertices.resize(unique);
+
+    stats.VerticesAfter = unique;
+    return stats;
+}
@@ -0,0 +1,40 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-16 09:32:18
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "TangentCalculator.hpp"
+
+/*
+    Hash based duplicate vertex elimination, run on freshly decoded vertices before tangent generation.
+    Vertices are keyed on position/normal/UV snapped to a grid of the given epsilon (0 = exact bitwise match, -0 == +0).
+    Cells are only looked up, never their neighbours: two vertices closer than epsilon that straddle a cell boundary stay separate.
+    Probing neighbours would mean 3^8 lookups per vertex and chains of welds, a snap-to-grid is what the loader needs.
+    Components too large for their epsilon (more than 2^24 cells from 0) are compared bitwise, the float spacing is already above epsilon there.
+    The survivor keeps its exact values.
+    One pass, open addressing table sized up front: O(n) time and no rehashing.
+*/
+
+struct WeldOptions
+{
+    float PositionEpsilon = 0.0f;
+    float NormalEpsilon = 0.0f;
+    float UVEpsilon = 0.0f;
+};
+
+struct WeldStats
+{
+    uint32_t VerticesBefore = 0;
+    uint32_t VerticesAfter = 0;
+};
+
+class VertexWelder
+{
+public:
+    /// @note(ame): compacts vertices in first-occurrence order and rewrites indices. Only Position, Normal and UV are compared.
+    static WeldStats Weld(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const WeldOptions& options);
+};
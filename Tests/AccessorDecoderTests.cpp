@@ -0,0 +1,64 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-27 10:02:41
+//
+
+#include "Test.hpp"
+#include "Util/AccessorDecoder.hpp"
+
+#include <cstring>
+#include <vector>
+
+TEST(DecodeFloatsStopsAtDestination)
+{
+    // An accessor longer than the destination (a TEXCOORD_0 longer than POSITION) must not write past it
+    const size_t count = 37;
+    const size_t dstCount = 21;
+
+    std::vector<int16_t> source(count * 4);
+    for (size_t i = 0; i < source.size(); i++) {
+        source[i] = static_cast<int16_t>(i * 101 - 1800);
+    }
+
+    cgltf_buffer buffer = {};
+    buffer.data = source.data();
+    buffer.size = source.size() * sizeof(int16_t);
+
+    cgltf_buffer_view view = {};
+    view.buffer = &buffer;
+    view.size = buffer.size;
+
+    cgltf_accessor accessor = {};
+    accessor.buffer_view = &view;
+    accessor.count = count;
+    accessor.stride = 4 * sizeof(int16_t);
+
+    // 16 bit goes through the SSE2 widening path, float through the plain copy
+    for (cgltf_component_type type : { cgltf_component_type_r_16, cgltf_component_type_r_32f }) {
+        accessor.component_type = type;
+        accessor.type = type == cgltf_component_type_r_16 ? cgltf_type_vec3 : cgltf_type_vec2;
+        uint32_t components = type == cgltf_component_type_r_16 ? 3 : 2;
+
+        std::vector<float> decoded((dstCount + 1) * 4, -1.0f);
+        AccessorDecoder::DecodeFloats(&accessor, decoded.data(), dstCount, 4 * sizeof(float), components);
+
+        uint32_t mismatches = 0;
+        for (size_t i = 0; i < dstCount; i++) {
+            for (uint32_t c = 0; c < components; c++) {
+                // Float bits are compared as bits, the int16 pattern read as floats can hold NaNs
+                float expected = static_cast<float>(source[i * 4 + c]);
+                if (type == cgltf_component_type_r_32f) {
+                    memcpy(&expected, reinterpret_cast<const uint8_t*>(source.data()) + i * accessor.stride + c * sizeof(float), sizeof(float));
+                }
+                mismatches += memcmp(&decoded[i * 4 + c], &expected, sizeof(float)) != 0;
+            }
+        }
+        CHECK(mismatches == 0);
+
+        uint32_t overruns = 0;
+        for (size_t i = dstCount * 4; i < decoded.size(); i++) {
+            overruns += decoded[i] != -1.0f;
+        }
+        CHECK(overruns == 0);
+    }
+}
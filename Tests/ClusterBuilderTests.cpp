@@ -0,0 +1,80 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 11:21:37
+//
+
+#include "Test.hpp"
+#include "TestMeshes.hpp"
+#include "Util/ClusterBuilder.hpp"
+#include "Util/MeshLocality.hpp"
+
+static glm::vec3 ClusterPosition(const std::vector<Vertex>& vertices, const ClusterData& data, const Cluster& cluster, uint32_t triangle, uint32_t corner)
+{
+    uint8_t local = data.Triangles[cluster.TriangleOffset + triangle * 3 + corner];
+    return vertices[data.Vertices[cluster.VertexOffset + local]].Position;
+}
+
+TEST(ClustersCoverEveryTriangle)
+{
+    // Bigger than CLUSTER_CHUNK_TRIANGLES so the chunked build and its concatenation get exercised
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeSphere(100, 200, 1.0f, 0.0f, vertices, indices);
+    indices.insert(indices.end(), { 5, 5, 6 }); // degenerate triangles must survive too
+    MeshLocality::Optimize(vertices, indices, TriangleOrder::Forsyth);
+
+    ClusterData data;
+    ClusterBuilder::Build(vertices.data(), vertices.size(), indices.data(), indices.size(), data);
+    CHECK(indices.size() / 3 > CLUSTER_CHUNK_TRIANGLES);
+    CHECK(ClusterBuilder::Validate(data, indices.data(), indices.size()));
+
+    // Locality optimized input should fill clusters well, not one triangle each
+    float averageTriangles = (indices.size() / 3) / static_cast<float>(data.Clusters.size());
+    CHECK(averageTriangles > CLUSTER_MAX_TRIANGLES / 2);
+
+    uint32_t outside = 0;
+    for (const Cluster& cluster : data.Clusters) {
+        for (uint32_t i = 0; i < cluster.VertexCount; i++) {
+            glm::vec3 p = vertices[data.Vertices[cluster.VertexOffset + i]].Position;
+            outside += glm::any(glm::lessThan(p, cluster.BoundsMin - 1e-5f)) || glm::any(glm::greaterThan(p, cluster.BoundsMax + 1e-5f));
+            outside += glm::length(p - cluster.Center) > cluster.Radius * 1.0001f + 1e-5f;
+        }
+    }
+    CHECK(outside == 0);
+
+    // Validate has to notice a broken cluster, otherwise the checks above mean nothing
+    data.Triangles[0] ^= 1;
+    CHECK(!ClusterBuilder::Validate(data, indices.data(), indices.size()));
+}
+
+TEST(ClusterConesAreConservative)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeSphere(60, 120, 1.0f, 0.0f, vertices, indices);
+    MeshLocality::Optimize(vertices, indices, TriangleOrder::Forsyth);
+
+    ClusterData data;
+    ClusterBuilder::Build(vertices.data(), vertices.size(), indices.data(), indices.size(), data);
+
+    // A culled cluster must not contain a single triangle facing the eye
+    uint32_t culled = 0;
+    uint32_t wrong = 0;
+    for (glm::vec3 eye : { glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(3.0f, -4.0f, 1.0f) }) {
+        for (const Cluster& cluster : data.Clusters) {
+            if (cluster.ConeCutoff >= 1.0f || glm::dot(glm::normalize(cluster.ConeApex - eye), cluster.ConeAxis) < cluster.ConeCutoff) {
+                continue;
+            }
+            culled++;
+            for (uint32_t t = 0; t < cluster.TriangleCount; t++) {
+                glm::vec3 p0 = ClusterPosition(vertices, data, cluster, t, 0);
+                glm::vec3 p1 = ClusterPosition(vertices, data, cluster, t, 1);
+                glm::vec3 p2 = ClusterPosition(vertices, data, cluster, t, 2);
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                wrong += glm::dot(normal, normal) > 0.0f && glm::dot(normal, p0 - eye) < 0.0f;
+            }
+        }
+    }
+    CHECK(wrong == 0);
+    CHECK(culled > 0);
+}
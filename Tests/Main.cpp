@@ -0,0 +1,56 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 10:20:04
+//
+
+#include "Test.hpp"
+#include "Util/JobSystem.hpp"
+
+uint32_t TestRegistry::mCurrentFailures = 0;
+
+std::vector<TestCase>& TestRegistry::GetTests()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+bool TestRegistry::Register(const char* name, const char* file, TestFunction function)
+{
+    GetTests().push_back({ name, file, function });
+    return true;
+}
+
+void TestRegistry::Fail(const char* file, int line, const std::string& expression)
+{
+    LOG_ERROR("    {}:{}: CHECK({}) failed", file, line, expression);
+    mCurrentFailures++;
+}
+
+uint32_t TestRegistry::RunAll()
+{
+    uint32_t failed = 0;
+    for (TestCase& test : GetTests()) {
+        mCurrentFailures = 0;
+        test.Function();
+        if (mCurrentFailures) {
+            LOG_ERROR("[FAIL] {} ({} failed checks)", test.Name, mCurrentFailures);
+            failed++;
+        } else {
+            LOG_INFO("[ OK ] {}", test.Name);
+        }
+    }
+    LOG_INFO("{} tests, {} failed", GetTests().size(), failed);
+    return failed;
+}
+
+int main(void)
+{
+    Oslo::Init();
+    JobSystem::Init();
+
+    uint32_t failed = TestRegistry::RunAll();
+
+    JobSystem::Exit();
+    Oslo::Exit();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 11:40:26
+//
+
+#include "Test.hpp"
+#include "TestMeshes.hpp"
+#include "Util/MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+/// @note(ame): exact point to triangle distance (Ericson, Real-Time Collision Detection 5.1.5).
+static float PointTriangleDistance(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c)
+{
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 ap = p - a;
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return glm::length(p - a);
+    }
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp);
+    float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return glm::length(p - b);
+    }
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return glm::length(p - (a + ab * (d1 / (d1 - d3))));
+    }
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp);
+    float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return glm::length(p - c);
+    }
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return glm::length(p - (a + ac * (d2 / (d2 - d6))));
+    }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return glm::length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+    }
+
+    float denominator = 1.0f / (va + vb + vc);
+    return glm::length(p - (a + ab * (vb * denominator) + ac * (vc * denominator)));
+}
+
+/// @note(ame): RMS distance of the original vertices to the simplified surface, the quantity LODLevel::Error estimates.
+static float MeasureError(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount)
+{
+    double sum = 0.0;
+    size_t samples = 0;
+    for (size_t v = 0; v < vertices.size(); v += 3) {
+        float best = FLT_MAX;
+        for (size_t i = 0; i < indexCount; i += 3) {
+            best = std::min(best, PointTriangleDistance(vertices[v].Position, vertices[indices[i]].Position, vertices[indices[i + 1]].Position, vertices[indices[i + 2]].Position));
+        }
+        sum += best * best;
+        samples++;
+    }
+    return static_cast<float>(std::sqrt(sum / samples));
+}
+
+TEST(LODChainReductionVsError)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeSphere(40, 80, 10.0f, 0.05f, vertices, indices);
+
+    LODOptions options;
+    std::vector<uint32_t> lodIndices;
+    std::vector<LODLevel> levels;
+    MeshSimplifier::BuildLODChain(vertices.data(), vertices.size(), indices.data(), indices.size(), options, lodIndices, levels);
+    CHECK(levels.size() >= 3);
+
+    float extent = 21.0f;
+    uint32_t previousCount = static_cast<uint32_t>(indices.size());
+    float previousError = 0.0f;
+    for (const LODLevel& level : levels) {
+        CHECK(level.IndexCount % 3 == 0);
+        CHECK(level.FirstIndex + level.IndexCount <= lodIndices.size());
+        CHECK(level.IndexCount < previousCount);
+        CHECK(level.Error >= previousError);
+        CHECK_LE(level.Error, options.MaxRelativeError * extent);
+
+        // Each level should land near Ratio of the previous one, only the last may stop short on MaxRelativeError
+        if (&level != &levels.back()) {
+            CHECK_LE(level.IndexCount, static_cast<uint32_t>(previousCount * options.Ratio * 1.25f));
+        }
+
+        // The reported error has to track the real deviation, within the slack of an RMS estimate
+        float measured = MeasureError(vertices, lodIndices.data() + level.FirstIndex, level.IndexCount);
+        CHECK_LE(measured, level.Error * 2.0f + 1e-3f);
+
+        previousCount = level.IndexCount;
+        previousError = level.Error;
+    }
+}
+
+TEST(SimplifyFlatGridIsFree)
+{
+    // A plane has zero quadric error everywhere except the locked border
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeWaveGrid(33, 0.0f, vertices, indices);
+    for (Vertex& vertex : vertices) {
+        vertex.Position.y = 0.0f;
+        vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+
+    std::vector<uint32_t> simplified;
+    float error = MeshSimplifier::Simplify(vertices.data(), vertices.size(), indices.data(), indices.size(), indices.size() / 8, FLT_MAX, SimplifyOptions(), simplified);
+    CHECK(!simplified.empty());
+    CHECK_LE(simplified.size(), indices.size() / 4);
+    CHECK_LE(error, 1e-4f);
+}
+
+TEST(SelectLODUsesWorldScale)
+{
+    LODLevel levels[3] = {
+        { 0, 300, 0.1f, 0 },
+        { 300, 150, 0.4f, 0 },
+        { 450, 60, 1.6f, 0 }
+    };
+
+    CHECK(MeshSimplifier::SelectLOD(levels, 3, 0.05f) == 0);
+    CHECK(MeshSimplifier::SelectLOD(levels, 3, 0.1f) == 1);
+    CHECK(MeshSimplifier::SelectLOD(levels, 3, 0.5f) == 2);
+    CHECK(MeshSimplifier::SelectLOD(levels, 3, 100.0f) == 3);
+
+    // Scaled up 4x the mesh space errors are 4x bigger in world space
+    CHECK(MeshSimplifier::SelectLOD(levels, 3, 0.5f, 4.0f) == 1);
+    CHECK(MeshSimplifier::SelectLOD(levels, 3, 0.1f, 0.25f) == 2);
+
+    glm::mat4 transform = glm::mat4(1.0f);
+    transform[0] *= 2.0f;
+    transform[1] *= 3.0f;
+    transform[2] *= 0.5f;
+    transform[3] = glm::vec4(100.0f, -4.0f, 7.0f, 1.0f);
+    CHECK(std::fabs(MeshSimplifier::MaxScale(transform) - 3.0f) < 1e-5f);
+
+    // Farther away never picks a finer level
+    uint32_t previous = 0;
+    bool monotonic = true;
+    for (float distance = 1.0f; distance < 1e5f; distance *= 2.0f) {
+        uint32_t lod = MeshSimplifier::SelectLODByDistance(levels, 3, distance, 0.001f);
+        monotonic &= lod >= previous;
+        previous = lod;
+    }
+    CHECK(monotonic);
+    CHECK(previous == 3);
+}
+
+TEST(SimplifySlidesAlongSeams)
+{
+    // Flat grid cut down the middle into two UV charts, the right one uses its own copy of the seam column
+    const uint32_t size = 33;
+    const uint32_t seam = size / 2;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeWaveGrid(size, 0.0f, vertices, indices);
+    for (uint32_t i = 0; i < vertices.size(); i++) {
+        vertices[i].Position.y = 0.0f;
+        vertices[i].Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        vertices[i].UV.x += i % size > seam ? 1.0f : 0.0f;
+    }
+
+    std::vector<uint32_t> copies(size);
+    for (uint32_t y = 0; y < size; y++) {
+        copies[y] = static_cast<uint32_t>(vertices.size());
+        Vertex vertex = vertices[y * size + seam];
+        vertex.UV.x += 1.0f;
+        vertices.push_back(vertex);
+    }
+    auto rightChart = [&](uint32_t vertex) { return vertex >= size * size || vertex % size > seam; };
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        bool right = rightChart(indices[i]) || rightChart(indices[i + 1]) || rightChart(indices[i + 2]);
+        for (size_t k = i; right && k < i + 3; k++) {
+            if (indices[k] % size == seam) {
+                indices[k] = copies[indices[k] / size];
+            }
+        }
+    }
+
+    std::vector<uint32_t> simplified;
+    MeshSimplifier::Simplify(vertices.data(), vertices.size(), indices.data(), indices.size(), 0, FLT_MAX, SimplifyOptions(), simplified);
+
+    // Only the border holds it back: its 128 vertices fan out to about as many triangles, a locked seam column would add ~60
+    CHECK(!simplified.empty());
+    CHECK_LE(simplified.size() / 3, 150u);
+
+    // Left chart UVs are in [0, 0.5], right chart ones in [1.5, 2]: no triangle may mix them
+    bool torn = false;
+    for (size_t i = 0; i < simplified.size(); i += 3) {
+        float minU = FLT_MAX;
+        float maxU = -FLT_MAX;
+        for (size_t k = i; k < i + 3; k++) {
+            minU = std::min(minU, vertices[simplified[k]].UV.x);
+            maxU = std::max(maxU, vertices[simplified[k]].UV.x);
+        }
+        torn |= minU < 1.0f && maxU > 1.0f;
+    }
+    CHECK(!torn);
+}
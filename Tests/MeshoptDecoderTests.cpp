@@ -0,0 +1,349 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 12:25:40
+//
+
+#include "Test.hpp"
+#include "Util/AccessorDecoder.hpp"
+#include "Util/MeshoptDecoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+/*
+    The decoder is checked against streams produced by the small encoders below, written from the extension spec independently of the decoder.
+    They only use a subset of each codec (greedy group modes, free-index triangles, baseline 0 sequences), but every header, group mode and tail path is hit.
+    The one hand written fixture is the index buffer example of the meshoptimizer test suite.
+*/
+
+static const uint8_t INDEX_FIXTURE_V0[] = {
+    0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00, 0x76, 0x87, 0x56, 0x67,
+    0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00
+};
+static const uint32_t INDEX_FIXTURE_DECODED[] = { 0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9 };
+
+static void EncodeVByte(std::vector<uint8_t>& out, uint32_t value)
+{
+    while (value >= 128) {
+        out.push_back(static_cast<uint8_t>((value & 127) | 128));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static uint32_t ZigZag(int32_t value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+/// @note(ame): ATTRIBUTES stream, the smallest of the 0/2/4/8 bit modes per 16 byte group.
+static std::vector<uint8_t> EncodeVertexFixture(const uint8_t* vertices, size_t count, size_t stride)
+{
+    std::vector<uint8_t> out = { 0xA0 };
+    size_t blockSize = std::min((8192 / stride) & ~size_t(15), size_t(256));
+    std::vector<uint8_t> last(vertices, vertices + stride);
+
+    for (size_t offset = 0; offset < count; offset += blockSize) {
+        size_t blockCount = std::min(blockSize, count - offset);
+        size_t alignedCount = (blockCount + 15) & ~size_t(15);
+
+        for (size_t k = 0; k < stride; k++) {
+            std::vector<uint8_t> deltas(alignedCount, 0);
+            uint8_t previous = last[k];
+            for (size_t i = 0; i < blockCount; i++) {
+                uint8_t current = vertices[(offset + i) * stride + k];
+                int8_t delta = static_cast<int8_t>(current - previous);
+                deltas[i] = static_cast<uint8_t>((delta << 1) ^ (delta >> 7));
+                previous = current;
+            }
+            last[k] = previous;
+
+            size_t groupCount = alignedCount / 16;
+            size_t headerOffset = out.size();
+            out.resize(out.size() + (groupCount + 3) / 4, 0);
+            for (size_t g = 0; g < groupCount; g++) {
+                const uint8_t* group = &deltas[g * 16];
+
+                std::vector<uint8_t> best;
+                int bestMode = -1;
+                for (int mode = 0; mode < 4; mode++) {
+                    std::vector<uint8_t> encoded;
+                    if (mode == 0) {
+                        if (std::any_of(group, group + 16, [](uint8_t d) { return d != 0; })) {
+                            continue;
+                        }
+                    } else if (mode == 3) {
+                        encoded.assign(group, group + 16);
+                    } else {
+                        int bits = 1 << mode;
+                        uint8_t sentinel = static_cast<uint8_t>((1 << bits) - 1);
+                        std::vector<uint8_t> extra;
+                        encoded.assign(bits * 2, 0);
+                        for (int i = 0; i < 16; i++) {
+                            uint8_t value = std::min(group[i], sentinel);
+                            if (group[i] >= sentinel) {
+                                extra.push_back(group[i]);
+                            }
+                            encoded[(i * bits) / 8] |= value << (8 - bits - (i * bits) % 8);
+                        }
+                        encoded.insert(encoded.end(), extra.begin(), extra.end());
+                    }
+                    if (bestMode < 0 || encoded.size() < best.size()) {
+                        best = encoded;
+                        bestMode = mode;
+                    }
+                }
+                out[headerOffset + g / 4] |= bestMode << ((g % 4) * 2);
+                out.insert(out.end(), best.begin(), best.end());
+            }
+        }
+    }
+
+    // Tail: padding up to 32 bytes, then the first vertex as the delta baseline
+    size_t tailSize = std::max(stride, size_t(32));
+    out.resize(out.size() + tailSize - stride, 0);
+    out.insert(out.end(), vertices, vertices + stride);
+    return out;
+}
+
+/// @note(ame): INDICES stream, every delta against baseline 0.
+static std::vector<uint8_t> EncodeSequenceFixture(const std::vector<uint32_t>& indices)
+{
+    std::vector<uint8_t> out = { 0xD1 };
+    uint32_t last[2] = {};
+    for (size_t i = 0; i < indices.size(); i++) {
+        uint32_t baseline = i & 1;
+        EncodeVByte(out, (ZigZag(static_cast<int32_t>(indices[i] - last[baseline])) << 1) | baseline);
+        last[baseline] = indices[i];
+    }
+    out.insert(out.end(), 4, 0);
+    return out;
+}
+
+/// @note(ame): TRIANGLES stream using only the 0xFF code with three free indices, no FIFO hits.
+static std::vector<uint8_t> EncodeTrianglesFixture(const std::vector<uint32_t>& indices)
+{
+    std::vector<uint8_t> codes;
+    std::vector<uint8_t> data;
+    uint32_t last = 0;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        codes.push_back(0xFF);
+        data.push_back(0xFF);
+        for (int k = 0; k < 3; k++) {
+            EncodeVByte(data, ZigZag(static_cast<int32_t>(indices[i + k] - last)));
+            last = indices[i + k];
+        }
+    }
+
+    std::vector<uint8_t> out = { 0xE1 };
+    out.insert(out.end(), codes.begin(), codes.end());
+    out.insert(out.end(), data.begin(), data.end());
+    out.insert(out.end(), 16, 0);
+    return out;
+}
+
+TEST(MeshoptIndexFixture)
+{
+    uint32_t indices[12] = {};
+    CHECK(MeshoptDecoder::DecodeIndexBuffer(indices, 12, 4, INDEX_FIXTURE_V0, sizeof(INDEX_FIXTURE_V0)));
+    CHECK(memcmp(indices, INDEX_FIXTURE_DECODED, sizeof(indices)) == 0);
+
+    uint16_t indices16[12] = {};
+    CHECK(MeshoptDecoder::DecodeIndexBuffer(indices16, 12, 2, INDEX_FIXTURE_V0, sizeof(INDEX_FIXTURE_V0)));
+    CHECK(std::equal(indices16, indices16 + 12, INDEX_FIXTURE_DECODED));
+
+    CHECK(!MeshoptDecoder::DecodeIndexBuffer(indices, 12, 4, INDEX_FIXTURE_V0, sizeof(INDEX_FIXTURE_V0) - 1));
+}
+
+TEST(MeshoptVertexFixtures)
+{
+    std::mt19937 rng(7);
+
+    // Smooth lanes compress to 0/2/4 bit groups, random ones force the 8 bit mode
+    uint32_t failures = 0;
+    for (size_t stride : { 4, 8, 12, 16, 32, 48, 256 }) {
+        for (size_t count : { 1, 15, 16, 17, 300, 5000 }) {
+            std::vector<uint8_t> vertices(count * stride);
+            for (size_t i = 0; i < count; i++) {
+                for (size_t k = 0; k < stride; k++) {
+                    vertices[i * stride + k] = (k % 3 == 0) ? static_cast<uint8_t>(rng()) : static_cast<uint8_t>(i * (k + 1) / 7);
+                }
+            }
+
+            std::vector<uint8_t> encoded = EncodeVertexFixture(vertices.data(), count, stride);
+            std::vector<uint8_t> decoded(count * stride, 0xCD);
+            failures += !MeshoptDecoder::DecodeVertexBuffer(decoded.data(), count, stride, encoded.data(), encoded.size());
+            failures += decoded != vertices;
+            failures += MeshoptDecoder::DecodeVertexBuffer(decoded.data(), count, stride, encoded.data(), encoded.size() - 1);
+        }
+    }
+    CHECK(failures == 0);
+}
+
+TEST(MeshoptIndexFixtures)
+{
+    std::mt19937 rng(11);
+    std::vector<uint32_t> indices(3000);
+    for (uint32_t& index : indices) {
+        index = rng() % 100000;
+    }
+
+    std::vector<uint32_t> decoded(indices.size());
+    std::vector<uint8_t> sequence = EncodeSequenceFixture(indices);
+    CHECK(MeshoptDecoder::DecodeIndexSequence(decoded.data(), decoded.size(), 4, sequence.data(), sequence.size()));
+    CHECK(decoded == indices);
+
+    std::fill(decoded.begin(), decoded.end(), 0);
+    std::vector<uint8_t> triangles = EncodeTrianglesFixture(indices);
+    CHECK(MeshoptDecoder::DecodeIndexBuffer(decoded.data(), decoded.size(), 4, triangles.data(), triangles.size()));
+    CHECK(decoded == indices);
+    CHECK(!MeshoptDecoder::DecodeIndexBuffer(decoded.data(), decoded.size(), 4, triangles.data(), triangles.size() - 17));
+}
+
+TEST(MeshoptFilters)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // Exponential: mantissa/exponent pairs decode to the exact float
+    float values[4] = { 1.0f, -2.5f, 0.125f, 1000.0f };
+    uint32_t encoded[4];
+    for (int i = 0; i < 4; i++) {
+        int exponent;
+        float mantissa = std::frexp(values[i], &exponent);
+        int32_t integer = static_cast<int32_t>(std::ldexp(mantissa, 23));
+        encoded[i] = (static_cast<uint32_t>(exponent - 23) << 24) | (static_cast<uint32_t>(integer) & 0xFFFFFF);
+    }
+    MeshoptDecoder::ApplyFilter(encoded, 1, 16, MeshoptFilter::Exponential);
+    CHECK(memcmp(encoded, values, sizeof(values)) == 0);
+
+    // Octahedral: snorm16 encoded unit vectors come back unit length, pointing the same way
+    float maxOctahedralError = 0.0f;
+    for (int t = 0; t < 1000; t++) {
+        glm::vec3 n = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)));
+        float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+        float u = n.x / l1;
+        float v = n.y / l1;
+        if (n.z < 0.0f) {
+            float folded = u;
+            u = (1.0f - std::fabs(v)) * (folded >= 0.0f ? 1.0f : -1.0f);
+            v = (1.0f - std::fabs(folded)) * (v >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        int16_t data[4] = { static_cast<int16_t>(std::lround(u * 32767)), static_cast<int16_t>(std::lround(v * 32767)), 32767, 0 };
+        MeshoptDecoder::ApplyFilter(data, 1, 8, MeshoptFilter::Octahedral);
+        glm::vec3 decoded = glm::vec3(data[0], data[1], data[2]) / 32767.0f;
+        maxOctahedralError = std::max(maxOctahedralError, std::fabs(glm::dot(decoded, n) - 1.0f));
+    }
+    CHECK_LE(maxOctahedralError, 1e-3f);
+
+    // Quaternion: the largest component is dropped and rebuilt
+    float maxQuaternionError = 0.0f;
+    for (int t = 0; t < 1000; t++) {
+        glm::vec4 q = glm::normalize(glm::vec4(unit(rng), unit(rng), unit(rng), unit(rng)));
+        int largest = 0;
+        for (int k = 1; k < 4; k++) {
+            if (std::fabs(q[k]) > std::fabs(q[largest])) {
+                largest = k;
+            }
+        }
+
+        float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+        int range = (1 << 12) - 1;
+        float scale = range * 1.41421356f;
+        int16_t data[4];
+        for (int k = 0; k < 3; k++) {
+            data[k] = static_cast<int16_t>(std::lround(q[(largest + k + 1) & 3] * sign * scale));
+        }
+        data[3] = static_cast<int16_t>((range & ~3) | largest);
+        MeshoptDecoder::ApplyFilter(data, 1, 8, MeshoptFilter::Quaternion);
+
+        glm::vec4 decoded = glm::vec4(data[0], data[1], data[2], data[3]) / 32767.0f;
+        maxQuaternionError = std::max(maxQuaternionError, std::fabs(glm::dot(decoded, q * sign) - 1.0f));
+    }
+    CHECK_LE(maxQuaternionError, 1e-3f);
+}
+
+TEST(MeshoptBufferViewsFeedAccessors)
+{
+    std::mt19937 rng(13);
+
+    const size_t count = 4096;
+    std::vector<int16_t> positions(count * 4);
+    for (size_t i = 0; i < count; i++) {
+        for (int k = 0; k < 3; k++) {
+            positions[i * 4 + k] = static_cast<int16_t>(rng());
+        }
+        positions[i * 4 + 3] = 0;
+    }
+    std::vector<uint32_t> indices(3 * 5000);
+    for (uint32_t& index : indices) {
+        index = rng() % count;
+    }
+
+    std::vector<uint8_t> encodedPositions = EncodeVertexFixture(reinterpret_cast<const uint8_t*>(positions.data()), count, 8);
+    std::vector<uint8_t> encodedIndices = EncodeTrianglesFixture(indices);
+    std::vector<uint8_t> blob = encodedPositions;
+    blob.insert(blob.end(), encodedIndices.begin(), encodedIndices.end());
+
+    cgltf_buffer buffer = {};
+    buffer.data = blob.data();
+    buffer.size = blob.size();
+
+    cgltf_buffer_view views[2] = {};
+    views[0].has_meshopt_compression = 1;
+    views[0].meshopt_compression.buffer = &buffer;
+    views[0].meshopt_compression.offset = 0;
+    views[0].meshopt_compression.size = encodedPositions.size();
+    views[0].meshopt_compression.stride = 8;
+    views[0].meshopt_compression.count = count;
+    views[0].meshopt_compression.mode = cgltf_meshopt_compression_mode_attributes;
+    views[0].meshopt_compression.filter = cgltf_meshopt_compression_filter_none;
+    views[1].has_meshopt_compression = 1;
+    views[1].meshopt_compression.buffer = &buffer;
+    views[1].meshopt_compression.offset = encodedPositions.size();
+    views[1].meshopt_compression.size = encodedIndices.size();
+    views[1].meshopt_compression.stride = 4;
+    views[1].meshopt_compression.count = indices.size();
+    views[1].meshopt_compression.mode = cgltf_meshopt_compression_mode_triangles;
+    views[1].meshopt_compression.filter = cgltf_meshopt_compression_filter_none;
+
+    cgltf_data data = {};
+    data.buffer_views = views;
+    data.buffer_views_count = 2;
+    CHECK(MeshoptDecoder::DecompressBufferViews(&data, true) == 2);
+    CHECK(memcmp(views[0].data, positions.data(), count * 8) == 0);
+    CHECK(memcmp(views[1].data, indices.data(), indices.size() * 4) == 0);
+
+    // KHR_mesh_quantization positions straight out of the decoded view, normalized and not
+    cgltf_accessor accessor = {};
+    accessor.component_type = cgltf_component_type_r_16;
+    accessor.type = cgltf_type_vec3;
+    accessor.count = count;
+    accessor.stride = 8;
+    accessor.buffer_view = &views[0];
+
+    for (bool normalized : { true, false }) {
+        accessor.normalized = normalized;
+
+        std::vector<float> decoded(count * 4, -1.0f);
+        AccessorDecoder::DecodeFloats(&accessor, decoded.data(), count, sizeof(float) * 4, 3);
+
+        uint32_t mismatches = 0;
+        for (size_t i = 0; i < count; i++) {
+            for (int k = 0; k < 3; k++) {
+                float expected = normalized ? positions[i * 4 + k] / 32767.0f : static_cast<float>(positions[i * 4 + k]);
+                mismatches += decoded[i * 4 + k] != expected;
+            }
+            mismatches += decoded[i * 4 + 3] != -1.0f;
+        }
+        CHECK(mismatches == 0);
+    }
+
+    free(views[0].data);
+    free(views[1].data);
+    views[0].data = nullptr;
+    views[1].data = nullptr;
+}
@@ -0,0 +1,214 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 12:58:19
+//
+
+#include "Test.hpp"
+#include "Util/MipGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+static double SRGBToLinear(double value)
+{
+    value /= 255.0;
+    return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+static double LinearToSRGB(double value)
+{
+    value = std::clamp(value, 0.0, 1.0);
+    return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+}
+
+/// @note(ame): one level of the box/polyphase box filter in double, source texels weighted by how much of them the destination covers.
+static std::vector<double> ReferenceLevel(const std::vector<double>& src, uint32_t width, uint32_t height, uint32_t& outWidth, uint32_t& outHeight)
+{
+    outWidth = std::max(width / 2, 1u);
+    outHeight = std::max(height / 2, 1u);
+
+    auto taps = [](uint32_t size, uint32_t outSize, uint32_t i, std::vector<std::pair<uint32_t, double>>& out) {
+        out.clear();
+        if (size == 1) {
+            out.push_back({ 0, 1.0 });
+        } else if (size % 2 == 0) {
+            out.push_back({ 2 * i, 0.5 });
+            out.push_back({ 2 * i + 1, 0.5 });
+        } else {
+            out.push_back({ 2 * i, (outSize - i) / double(size) });
+            out.push_back({ 2 * i + 1, outSize / double(size) });
+            out.push_back({ 2 * i + 2, (i + 1.0) / size });
+        }
+    };
+
+    std::vector<double> out(size_t(outWidth) * outHeight * 4, 0.0);
+    std::vector<std::pair<uint32_t, double>> tapsX, tapsY;
+    for (uint32_t y = 0; y < outHeight; y++) {
+        for (uint32_t x = 0; x < outWidth; x++) {
+            taps(width, outWidth, x, tapsX);
+            taps(height, outHeight, y, tapsY);
+            for (auto [sy, wy] : tapsY) {
+                for (auto [sx, wx] : tapsX) {
+                    for (int c = 0; c < 4; c++) {
+                        out[(size_t(y) * outWidth + x) * 4 + c] += wy * wx * src[(size_t(sy) * width + sx) * 4 + c];
+                    }
+                }
+            }
+        }
+    }
+    return out;
+}
+
+/// @note(ame): largest 8 bit difference to the double reference over the whole chain, exact .5 rounding ties excluded.
+static int CompareWithReference(uint32_t width, uint32_t height, MipFilter filter, bool parallel)
+{
+    std::mt19937 rng(width * 31 + height);
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+    for (uint8_t& pixel : pixels) {
+        pixel = static_cast<uint8_t>(rng());
+    }
+
+    std::vector<double> level(pixels.size());
+    for (size_t i = 0; i < pixels.size(); i++) {
+        bool color = i % 4 < 3;
+        if (filter == MipFilter::SRGB && color) {
+            level[i] = SRGBToLinear(pixels[i]);
+        } else if (filter == MipFilter::Normal && color) {
+            level[i] = pixels[i] / 127.5 - 1.0;
+        } else {
+            level[i] = pixels[i] / 255.0;
+        }
+    }
+
+    std::vector<uint8_t> chain = pixels;
+    GenerateMipChain(chain, width, height, filter, parallel);
+    uint32_t levels = MipLevelCount(width, height);
+    if (chain.size() != MipChainSize(width, height, levels)) {
+        return 255;
+    }
+
+    int maxError = 0;
+    size_t offset = size_t(width) * height * 4;
+    for (uint32_t l = 1; l < levels; l++) {
+        uint32_t levelWidth, levelHeight;
+        level = ReferenceLevel(level, width, height, levelWidth, levelHeight);
+
+        for (size_t t = 0; t < size_t(levelWidth) * levelHeight; t++) {
+            const double* v = &level[t * 4];
+            double expected[4];
+            if (filter == MipFilter::Normal) {
+                double length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+                for (int c = 0; c < 3; c++) {
+                    expected[c] = length > 1e-6 ? std::clamp(v[c] / length * 0.5 + 0.5, 0.0, 1.0) * 255.0 : (c == 2 ? 255.0 : 128.0);
+                }
+            } else {
+                for (int c = 0; c < 3; c++) {
+                    expected[c] = (filter == MipFilter::SRGB ? LinearToSRGB(v[c]) : std::clamp(v[c], 0.0, 1.0)) * 255.0;
+                }
+            }
+            expected[3] = std::clamp(v[3], 0.0, 1.0) * 255.0;
+
+            for (int c = 0; c < 4; c++) {
+                int error = std::abs(int(chain[offset + t * 4 + c]) - int(expected[c] + 0.5));
+                bool tie = std::fabs(expected[c] - std::floor(expected[c]) - 0.5) < 1e-3;
+                if (error && tie && (c == 3 || filter != MipFilter::Normal)) {
+                    continue;
+                }
+                maxError = std::max(maxError, error);
+            }
+        }
+        offset += size_t(levelWidth) * levelHeight * 4;
+        width = levelWidth;
+        height = levelHeight;
+    }
+    return maxError;
+}
+
+TEST(MipLevelCounts)
+{
+    CHECK(MipLevelCount(1, 1) == 1);
+    CHECK(MipLevelCount(1024, 512) == 11);
+    CHECK(MipLevelCount(37, 5) == 6);
+    CHECK(MipLevelCount(1, 7) == 3);
+    CHECK(MipChainSize(3, 1, 2) == 16);
+    CHECK(MipChainSize(4, 4, 3) == (16 + 4 + 1) * 4);
+}
+
+TEST(MipOddDimensions)
+{
+    // 3 taps of a third each: a lone white texel in the middle of 3x1 becomes 85, not 127 or 0
+    std::vector<uint8_t> pixels = { 0, 0, 0, 0, 255, 255, 255, 255, 0, 0, 0, 0 };
+    GenerateMipChain(pixels, 3, 1, MipFilter::Linear);
+    CHECK(pixels[12] == 85 && pixels[15] == 85);
+
+    // A constant image stays constant through every odd level
+    for (MipFilter filter : { MipFilter::Linear, MipFilter::SRGB }) {
+        std::vector<uint8_t> constant;
+        for (int i = 0; i < 37 * 5; i++) {
+            constant.insert(constant.end(), { 200, 100, 7, 128 });
+        }
+        GenerateMipChain(constant, 37, 5, filter);
+
+        uint32_t mismatches = 0;
+        const uint8_t expected[4] = { 200, 100, 7, 128 };
+        for (size_t i = 0; i < constant.size(); i++) {
+            mismatches += constant[i] != expected[i % 4];
+        }
+        CHECK(mismatches == 0);
+    }
+
+    for (auto [width, height] : { std::pair<uint32_t, uint32_t>{ 1, 9 }, { 7, 1 }, { 5, 5 }, { 37, 5 }, { 255, 129 } }) {
+        CHECK(CompareWithReference(width, height, MipFilter::Linear, false) == 0);
+        CHECK(CompareWithReference(width, height, MipFilter::SRGB, false) == 0);
+        CHECK_LE(CompareWithReference(width, height, MipFilter::Normal, false), 1);
+    }
+}
+
+TEST(MipSRGB)
+{
+    // Black/white checker averages to linear 0.5, which is 188 in sRGB (a naive average gives 128). Alpha stays linear.
+    std::vector<uint8_t> checker = { 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 255 };
+    GenerateMipChain(checker, 2, 2, MipFilter::SRGB);
+    CHECK(checker[16] == 188);
+    CHECK(checker[19] == 255);
+
+    // Every pair of sRGB values, against the exactly rounded curve
+    uint32_t mismatches = 0;
+    for (int a = 0; a < 256; a++) {
+        for (int b = 0; b < 256; b++) {
+            std::vector<uint8_t> pair = { uint8_t(a), uint8_t(a), uint8_t(a), uint8_t(a), uint8_t(b), uint8_t(b), uint8_t(b), uint8_t(b) };
+            GenerateMipChain(pair, 2, 1, MipFilter::SRGB, false);
+
+            double expected = LinearToSRGB((SRGBToLinear(a) + SRGBToLinear(b)) * 0.5) * 255.0;
+            bool tie = std::fabs(expected - std::floor(expected) - 0.5) < 1e-4;
+            mismatches += pair[8] != int(expected + 0.5) && !tie;
+            mismatches += std::abs(pair[11] - (a + b) * 0.5) > 0.51;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST(MipNormals)
+{
+    // +X and +Z average to a renormalized 45 degree normal, not a shortened one
+    std::vector<uint8_t> normals = { 255, 128, 128, 255, 128, 128, 255, 255 };
+    GenerateMipChain(normals, 2, 1, MipFilter::Normal);
+    CHECK(normals[8] == 218 && normals[10] == 218);
+    CHECK(std::abs(normals[9] - 128) <= 1);
+}
+
+TEST(MipParallelMatchesSerial)
+{
+    std::mt19937 rng(17);
+    std::vector<uint8_t> parallel(601 * 333 * 4);
+    for (uint8_t& pixel : parallel) {
+        pixel = static_cast<uint8_t>(rng());
+    }
+    std::vector<uint8_t> serial = parallel;
+
+    GenerateMipChain(parallel, 601, 333, MipFilter::SRGB, true);
+    GenerateMipChain(serial, 601, 333, MipFilter::SRGB, false);
+    CHECK(parallel == serial);
+}
@@ -0,0 +1,74 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 12:17:48
+//
+
+#include "Test.hpp"
+#include "TestMeshes.hpp"
+#include "Util/JobSystem.hpp"
+#include "Util/TangentSpace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+TEST(TangentAccumulatedAgreesWithMikkTSpace)
+{
+    // On a smooth parameterization both methods describe the same frame. V is flipped so cross(N, T) points along dP/dv:
+    // on mirrored frames the accumulated path negates the tangent where MikkTSpace negates the bitangent, they only compare unmirrored.
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeWaveGrid(256, 0.3f, vertices, indices);
+    for (Vertex& vertex : vertices) {
+        vertex.UV.y = 1.0f - vertex.UV.y;
+    }
+
+    std::vector<Vertex> accumulated = vertices;
+    TangentSpace::ComputeReference(accumulated, indices);
+
+    TangentCalculator calculator;
+    MeshData data = { vertices.data(), indices.data(), vertices.size(), indices.size() };
+    CHECK(calculator.Calculate(&data));
+
+    float minTangentDot = 1.0f;
+    float minBitangentDot = 1.0f;
+    float maxOrthogonality = 0.0f;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        minTangentDot = std::min(minTangentDot, glm::dot(glm::normalize(accumulated[i].Tangent), glm::normalize(vertices[i].Tangent)));
+        minBitangentDot = std::min(minBitangentDot, glm::dot(glm::normalize(accumulated[i].Bitangent), glm::normalize(vertices[i].Bitangent)));
+        maxOrthogonality = std::max(maxOrthogonality, std::fabs(glm::dot(vertices[i].Tangent, vertices[i].Normal)));
+    }
+    CHECK(minTangentDot > 0.999f);
+    // MikkTSpace keeps the bitangent along dP/dv, the accumulated path rebuilds it as cross(N, T), they part where the UVs shear
+    CHECK(minBitangentDot > 0.95f);
+    CHECK_LE(maxOrthogonality, 1e-3f);
+}
+
+TEST(MikkTSpaceIsReentrant)
+{
+    // Primitives get their tangents from several jobs at once, the result must not depend on it
+    const uint32_t count = 8;
+    std::vector<std::vector<Vertex>> parallel(count);
+    std::vector<std::vector<Vertex>> serial(count);
+    std::vector<std::vector<uint32_t>> indices(count);
+    for (uint32_t i = 0; i < count; i++) {
+        MakeWaveGrid(64 + i * 7, i * 0.5f, parallel[i], indices[i]);
+        serial[i] = parallel[i];
+
+        TangentCalculator calculator;
+        MeshData data = { serial[i].data(), indices[i].data(), serial[i].size(), indices[i].size() };
+        calculator.Calculate(&data);
+    }
+
+    JobSystem::ParallelFor(count, [&](uint32_t i) {
+        TangentCalculator calculator;
+        MeshData data = { parallel[i].data(), indices[i].data(), parallel[i].size(), indices[i].size() };
+        calculator.Calculate(&data);
+    });
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        mismatches += memcmp(parallel[i].data(), serial[i].data(), serial[i].size() * sizeof(Vertex)) != 0;
+    }
+    CHECK(mismatches == 0);
+}
@@ -0,0 +1,30 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 12:02:11
+//
+
+#include "Test.hpp"
+#include "TestMeshes.hpp"
+#include "Util/TangentSpace.hpp"
+
+#include <cstring>
+
+TEST(TangentComputeMatchesReference)
+{
+    // Odd triangle count so the scalar tail of the 4 wide loop runs as well
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeWaveGrid(257, 0.3f, vertices, indices);
+    indices.insert(indices.end(), { 0, 258, 1 });
+
+    std::vector<Vertex> reference = vertices;
+    TangentSpace::ComputeReference(reference, indices);
+    TangentSpace::Compute(vertices.data(), vertices.size(), indices.data(), indices.size());
+
+    // Same expressions, same summation order per vertex: the frames have to match bit for bit
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        mismatches += memcmp(&vertices[i], &reference[i], sizeof(Vertex)) != 0;
+    }
+    CHECK(mismatches == 0);
+}
@@ -0,0 +1,62 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 10:12:37
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include <string>
+#include <vector>
+
+/*
+    Minimal test registry for the CPU side of the loader (Source/Util), no window and no GPU.
+    TEST(Name) registers a function at static init time, Tests/Main.cpp runs every registered test and returns the number of failed ones.
+    CHECK records a failure and keeps going, so one run reports every broken assertion of a test.
+        xmake build test && xmake run test
+*/
+
+typedef void (*TestFunction)();
+
+struct TestCase
+{
+    const char* Name;
+    const char* File;
+    TestFunction Function;
+};
+
+class TestRegistry
+{
+public:
+    static bool Register(const char* name, const char* file, TestFunction function);
+    static void Fail(const char* file, int line, const std::string& expression);
+
+    /// @note(ame): returns the number of tests with at least one failed CHECK.
+    static uint32_t RunAll();
+private:
+    static std::vector<TestCase>& GetTests();
+    static uint32_t mCurrentFailures;
+};
+
+#define TEST(name) \
+    static void Test_##name(); \
+    static bool Test_##name##_Registered = TestRegistry::Register(#name, __FILE__, Test_##name); \
+    static void Test_##name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            TestRegistry::Fail(__FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+/// @note(ame): same as CHECK, with the measured value in the failure message.
+#define CHECK_LE(value, bound) \
+    do { \
+        auto checkValue = (value); \
+        auto checkBound = (bound); \
+        if (!(checkValue <= checkBound)) { \
+            TestRegistry::Fail(__FILE__, __LINE__, std::string(#value " <= " #bound ", got ") + std::to_string(checkValue) + " > " + std::to_string(checkBound)); \
+        } \
+    } while (0)
@@ -0,0 +1,64 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 11:09:48
+//
+
+#include "TestMeshes.hpp"
+
+#include <cmath>
+
+void MakeSphere(uint32_t rings, uint32_t segments, float radius, float bumps, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    const float pi = 3.14159265f;
+
+    vertices.clear();
+    indices.clear();
+    for (uint32_t r = 0; r <= rings; r++) {
+        for (uint32_t s = 0; s <= segments; s++) {
+            float theta = pi * r / rings;
+            float phi = 2.0f * pi * s / segments;
+            glm::vec3 direction = glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+
+            Vertex vertex = {};
+            vertex.Position = direction * radius * (1.0f + bumps * std::sin(5.0f * theta) * std::cos(7.0f * phi));
+            vertex.Normal = direction;
+            vertex.UV = glm::vec2(s / static_cast<float>(segments), r / static_cast<float>(rings));
+            vertices.push_back(vertex);
+        }
+    }
+    for (uint32_t r = 0; r < rings; r++) {
+        for (uint32_t s = 0; s < segments; s++) {
+            uint32_t i = r * (segments + 1) + s;
+            indices.insert(indices.end(), { i, i + 1, i + segments + 1, i + 1, i + segments + 2, i + segments + 1 });
+        }
+    }
+}
+
+void MakeWaveGrid(uint32_t size, float phase, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    vertices.assign(size * size, {});
+    indices.clear();
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            float fx = x / static_cast<float>(size - 1);
+            float fy = y / static_cast<float>(size - 1);
+            float height = 0.2f * std::sin(6.0f * fx + phase) * std::cos(5.0f * fy);
+            float dx = 1.2f * std::cos(6.0f * fx + phase) * std::cos(5.0f * fy);
+            float dy = -1.0f * std::sin(6.0f * fx + phase) * std::sin(5.0f * fy);
+
+            Vertex& vertex = vertices[y * size + x];
+            vertex.Position = glm::vec3(fx, height, fy);
+            vertex.Normal = glm::normalize(glm::vec3(-dx, 1.0f, -dy));
+            vertex.UV = glm::vec2(fx, fy);
+        }
+    }
+    for (uint32_t y = 0; y < size - 1; y++) {
+        for (uint32_t x = 0; x < size - 1; x++) {
+            uint32_t a = y * size + x;
+            uint32_t b = a + 1;
+            uint32_t c = a + size;
+            uint32_t d = c + 1;
+            indices.insert(indices.end(), { a, c, b, b, c, d });
+        }
+    }
+}
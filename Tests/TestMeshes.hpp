@@ -0,0 +1,17 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 11:03:15
+//
+
+#pragma once
+
+#include <Oslo/Oslo.hpp>
+
+#include "Util/TangentCalculator.hpp"
+
+/// @note(ame): UV sphere of (rings + 1) * (segments + 1) vertices, outward facing, counter clockwise.
+/// bumps > 0 modulates the radius so the surface isn't trivially simplified. The seam column is duplicated like a real UV seam.
+void MakeSphere(uint32_t rings, uint32_t segments, float radius, float bumps, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+/// @note(ame): size * size height field over [0, 1]^2 with analytic normals and planar UVs.
+void MakeWaveGrid(uint32_t size, float phase, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
@@ -0,0 +1,84 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 10:31:52
+//
+
+#include "Test.hpp"
+#include "Util/VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+static float AngleDegrees(glm::vec3 a, glm::vec3 b)
+{
+    return std::acos(std::clamp(glm::dot(a, b), -1.0f, 1.0f)) * 57.2957795f;
+}
+
+static VertexAttributes RandomAttributes(std::mt19937& rng, bool flipped)
+{
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> uv(-4.0f, 4.0f);
+
+    VertexAttributes attributes = {};
+    attributes.Normal = glm::normalize(glm::vec3(direction(rng), direction(rng), direction(rng)));
+    attributes.Tangent = glm::normalize(glm::cross(attributes.Normal, glm::normalize(glm::vec3(direction(rng), direction(rng), direction(rng)))));
+    attributes.Bitangent = glm::cross(attributes.Normal, attributes.Tangent) * (flipped ? -1.0f : 1.0f);
+    attributes.UV = glm::vec2(uv(rng), uv(rng));
+    return attributes;
+}
+
+TEST(HalfRoundTripsEveryFiniteValue)
+{
+    uint32_t mismatches = 0;
+    for (uint32_t bits = 0; bits < 65536; bits++) {
+        if (((bits >> 10) & 0x1F) == 0x1F) {
+            continue;
+        }
+        mismatches += FloatToHalf(HalfToFloat(static_cast<uint16_t>(bits))) != bits;
+    }
+    CHECK(mismatches == 0);
+
+    CHECK(FloatToHalf(1.0f) == 0x3C00);
+    CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+    CHECK(FloatToHalf(-2.0f) == 0xC000);
+}
+
+TEST(OctahedralErrorBound)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+    float maxAngle = 0.0f;
+    for (int i = 0; i < 200000; i++) {
+        glm::vec3 n = glm::normalize(glm::vec3(direction(rng), direction(rng), direction(rng)));
+        maxAngle = std::max(maxAngle, AngleDegrees(n, DecodeOctahedral(EncodeOctahedral(n))));
+    }
+    // The poles and the folded corners of the octahedron are the worst cases
+    for (glm::vec3 n : { glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(1, 0, 0), glm::vec3(0, -1, 0), glm::normalize(glm::vec3(1, 1, -1)) }) {
+        maxAngle = std::max(maxAngle, AngleDegrees(n, DecodeOctahedral(EncodeOctahedral(n))));
+    }
+    CHECK_LE(maxAngle, 0.05f);
+}
+
+TEST(CompactAttributesErrorBound)
+{
+    std::mt19937 rng(2);
+
+    float maxAngle = 0.0f;
+    float maxUVError = 0.0f;
+    uint32_t signErrors = 0;
+    for (int i = 0; i < 200000; i++) {
+        VertexAttributes source = RandomAttributes(rng, i & 1);
+        VertexAttributes decoded = DecodeAttributes(EncodeAttributes(source));
+
+        maxAngle = std::max({ maxAngle, AngleDegrees(source.Normal, decoded.Normal), AngleDegrees(source.Tangent, decoded.Tangent) });
+        signErrors += glm::dot(source.Bitangent, decoded.Bitangent) < 0.9f;
+        for (int c = 0; c < 2; c++) {
+            maxUVError = std::max(maxUVError, std::fabs(decoded.UV[c] - source.UV[c]) / std::max(std::fabs(source.UV[c]), 1e-3f));
+        }
+    }
+    CHECK_LE(maxAngle, 0.05f);
+    CHECK_LE(maxUVError, 1.0f / 2048.0f);
+    CHECK(signErrors == 0);
+}
@@ -0,0 +1,50 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-26 10:44:09
+//
+
+#include "Test.hpp"
+#include "Util/VertexStreams.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <random>
+
+TEST(SplitStreamsRoundTrip)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> value(-50.0f, 50.0f);
+
+    const size_t count = 10000;
+    std::vector<Vertex> vertices(count);
+    for (Vertex& vertex : vertices) {
+        vertex.Position = glm::vec3(value(rng), value(rng), value(rng));
+        vertex.Normal = glm::vec3(value(rng), value(rng), value(rng));
+        vertex.UV = glm::vec2(value(rng), value(rng));
+        vertex.Tangent = glm::vec3(value(rng), value(rng), value(rng));
+        vertex.Bitangent = glm::vec3(value(rng), value(rng), value(rng));
+    }
+
+    std::vector<glm::vec3> positions(count);
+    std::vector<VertexAttributes> attributes(count);
+    SplitVertexStreams(vertices.data(), count, positions.data(), attributes.data());
+
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < count; i++) {
+        mismatches += positions[i] != vertices[i].Position;
+
+        Vertex merged = MergeVertexStreams(positions[i], attributes[i]);
+        mismatches += memcmp(&merged, &vertices[i], sizeof(Vertex)) != 0;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST(SplitStreamsLayout)
+{
+    // The shaders read positions as a tight float3 stream and attributes at a 44 byte stride
+    CHECK(sizeof(glm::vec3) == 12);
+    CHECK(offsetof(VertexAttributes, Normal) == 0);
+    CHECK(offsetof(VertexAttributes, UV) == 12);
+    CHECK(offsetof(VertexAttributes, Tangent) == 20);
+    CHECK(offsetof(VertexAttributes, Bitangent) == 32);
+}
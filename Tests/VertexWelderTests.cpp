@@ -0,0 +1,81 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-04-27 09:14:06
+//
+
+#include "Test.hpp"
+#include "TestMeshes.hpp"
+#include "Util/VertexWelder.hpp"
+
+static Vertex MakeVertex(glm::vec3 position, glm::vec2 uv)
+{
+    Vertex vertex = {};
+    vertex.Position = position;
+    vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    vertex.UV = uv;
+    return vertex;
+}
+
+TEST(WeldExactDuplicates)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MakeWaveGrid(16, 0.0f, vertices, indices);
+    size_t original = vertices.size();
+
+    // Unindex the grid: every corner gets its own copy
+    std::vector<Vertex> expanded;
+    for (uint32_t& index : indices) {
+        expanded.push_back(vertices[index]);
+        index = static_cast<uint32_t>(expanded.size() - 1);
+    }
+
+    WeldStats stats = VertexWelder::Weld(expanded, indices, WeldOptions{});
+    CHECK(stats.VerticesAfter == original);
+    CHECK(expanded.size() == original);
+    for (uint32_t index : indices) {
+        CHECK(index < expanded.size());
+    }
+}
+
+TEST(WeldSnapsToCells)
+{
+    WeldOptions options;
+    options.PositionEpsilon = 1e-3f;
+
+    std::vector<Vertex> vertices = {
+        MakeVertex(glm::vec3(0.1002f, 0.0f, 0.0f), glm::vec2(0.0f)),
+        MakeVertex(glm::vec3(0.1004f, 0.0f, 0.0f), glm::vec2(0.0f)),
+        MakeVertex(glm::vec3(0.1012f, 0.0f, 0.0f), glm::vec2(0.0f)),
+        MakeVertex(glm::vec3(-0.0f, 0.0f, 0.0f), glm::vec2(0.0f)),
+        MakeVertex(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec2(0.0f))
+    };
+    std::vector<uint32_t> indices = { 0, 1, 2, 3, 4, 0 };
+
+    VertexWelder::Weld(vertices, indices, options);
+    CHECK(vertices.size() == 3);
+    CHECK(indices[0] == indices[1]);
+    CHECK(indices[1] != indices[2]);
+    CHECK(indices[3] == indices[4]);
+}
+
+TEST(WeldLargeCoordinates)
+{
+    // 1e9 / 1e-6 is far past the int32 range: distinct floats stay apart, equal ones still weld
+    WeldOptions options;
+    options.PositionEpsilon = 1e-6f;
+
+    std::vector<Vertex> vertices = {
+        MakeVertex(glm::vec3(1e9f, -3e9f, 0.0f), glm::vec2(0.0f)),
+        MakeVertex(glm::vec3(1e9f, -3e9f, 0.0f), glm::vec2(0.0f)),
+        MakeVertex(glm::vec3(1.0001e9f, -3e9f, 0.0f), glm::vec2(0.0f)),
+        MakeVertex(glm::vec3(-1e9f, 3e9f, 0.0f), glm::vec2(0.0f))
+    };
+    std::vector<uint32_t> indices = { 0, 1, 2, 1, 3, 0 };
+
+    VertexWelder::Weld(vertices, indices, options);
+    CHECK(vertices.size() == 3);
+    CHECK(indices[0] == indices[1]);
+    CHECK(indices[2] != indices[0]);
+    CHECK(indices[4] != indices[0]);
+}
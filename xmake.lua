@@ -7,6 +7,13 @@ add_rules("mode.debug", "mode.release", "mode.releasedbg")
 
 includes("Oslo", "External")
 
+option("block_compression")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Upload textures as BC1/BC5/BC7, needs an Oslo with those formats and block row uploads")
+    add_defines("PATHTRACER_BLOCK_COMPRESSION")
+option_end()
+
 target("Pathtracer")
     set_rundir(".")
     set_kind("binary")
@@ -14,6 +21,36 @@ target("Pathtracer")
     add_files("Source/**.cpp")
     add_includedirs("Oslo", "Source", "External")
     add_deps("Oslo", "mikktspace")
+    add_options("block_compression")
+
+    before_link(function (target)
+        os.cp("Oslo/Binaries/*", "$(buildir)/$(plat)/$(arch)/$(mode)/")
+    end)
+
+-- CPU tests of Source/Util, no window or GPU: xmake build test && xmake run test
+target("test")
+    set_default(false)
+    set_rundir(".")
+    set_kind("binary")
+
+    add_files("Tests/**.cpp", "Source/Util/*.cpp")
+    add_includedirs("Oslo", "Source", "External")
+    add_deps("Oslo", "mikktspace")
+
+    before_link(function (target)
+        os.cp("Oslo/Binaries/*", "$(buildir)/$(plat)/$(arch)/$(mode)/")
+    end)
+
+-- Loader benchmarks over the Assets folder, prints timings only: xmake build bench && xmake run bench [filter]
+target("bench")
+    set_default(false)
+    set_rundir(".")
+    set_kind("binary")
+
+    add_files("Bench/**.cpp", "Source/**.cpp|Main.cpp")
+    add_includedirs("Oslo", "Source", "External")
+    add_deps("Oslo", "mikktspace")
+    add_options("block_compression")
 
     before_link(function (target)
         os.cp("Oslo/Binaries/*", "$(buildir)/$(plat)/$(arch)/$(mode)/")